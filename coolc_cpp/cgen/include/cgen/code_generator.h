@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "cgen/emitter.h"
+#include "parser/syntax.h"
+#include "semant/inheritance.h"
+#include "semant/type_checker.h"
+
+// Generates SPIM assembly for a program the type checker accepted, against
+// the runtime of the reference compiler (trap.handler): its object layout,
+// its methods of the basic classes and the tables it expects. The code is
+// that of a stack machine, as in the reference cgen: every expression
+// leaves its value in $a0, self is kept in $s0, intermediate values go on
+// the stack and names bound by lets and cases into slots of the frame,
+// unless RegisterAllocator finds them registers.
+//
+// A frame, from $fp up: the slots of spilled bindings, the $s registers the
+// method uses, the saved $ra, $s0 and $fp, then the arguments, the last one
+// first. The callee pops them.
+//
+// The tag of a class is its position in the pre-order of the hierarchy, so
+// a class and its descendants have a range of tags: a case branch tests
+// that range.
+class CodeGenerator {
+   public:
+    // without `allocateRegisters` every value stays in memory, the code of a
+    // plain stack machine
+    CodeGenerator(const InheritanceAnalyzer& inheritance, const TypeChecker& checker, bool allocateRegisters = true);
+
+    void Generate(OutputBuffer& out);
+
+    // the text of a string constant as the lexer spells it, escapes undone
+    static std::string Unescape(std::string_view text);
+
+    using ClassId = ClassGraph::ClassId;
+
+    // what the generation of methods needs to know about the program
+    const ClassGraph& Graph() const { return graph_; }
+    const ClassLayout& Layout() const { return layout_; }
+    ClassId Find(Symbol cls) const { return graph_.Find(cls); }
+    uint32_t Tag(ClassId id) const { return tags_[id]; }
+    // the greatest tag of `id` and its descendants
+    uint32_t LastTag(ClassId id) const { return lastTags_[id]; }
+    std::size_t Depth(ClassId id) const { return hierarchy_.Depth(id); }
+    std::size_t StringConstant(Symbol literal) const { return literals_.at(literal); }
+    std::size_t StringConstant(std::string_view text) const { return strings_.at(std::string(text)); }
+    std::size_t IntConstant(int32_t value) const { return ints_.at(value); }
+    // puts in $a0 what a variable of `type` starts out with: the constant
+    // 0, "" or false for the basic classes, void for others
+    void EmitDefault(Emitter& emitter, Symbol type) const;
+
+   private:
+    void CollectConstants();
+    std::size_t AddString(std::string text);
+    std::size_t AddInt(int32_t value);
+
+    void EmitGlobals(Emitter& emitter);
+    void EmitConstants(Emitter& emitter);
+    void EmitClassTables(Emitter& emitter);
+    void EmitPrototypes(Emitter& emitter);
+    void EmitInit(Emitter& emitter, ClassId id);
+    void EmitMethod(Emitter& emitter, ClassId id, const Feature& method);
+
+   private:
+    const ClassGraph& graph_;
+    const ClassHierarchy& hierarchy_;
+    const ClassLayout& layout_;
+    ClassId firstClass_;
+    std::vector<uint32_t> tags_;
+    std::vector<uint32_t> lastTags_;
+    const bool allocateRegisters_;
+
+    // constants by number, and the numbers by value
+    std::vector<std::string> stringValues_;
+    std::unordered_map<std::string, std::size_t> strings_;
+    std::unordered_map<Symbol, std::size_t> literals_;
+    std::vector<int32_t> intValues_;
+    std::unordered_map<int32_t, std::size_t> ints_;
+    // labels handed out so far, shared by all methods
+    std::size_t labels_ = 0;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "lexer/symbol.h"
+#include "parser/output_buffer.h"
+
+// Operands of an instruction, printed into the buffer as they are, with no
+// string built for them.
+struct Mem {
+    int32_t offset;
+    std::string_view reg;
+};
+
+// Class_protObj, Class_dispTab, Class_init
+struct ClassLabel {
+    Symbol cls;
+    std::string_view suffix;
+};
+
+// Class.method
+struct MethodLabel {
+    Symbol cls;
+    Symbol method;
+};
+
+// label12, int_const3, str_const0
+struct NumberedLabel {
+    std::string_view prefix;
+    std::size_t number;
+};
+
+inline OutputBuffer& operator<<(OutputBuffer& out, const Mem& mem) {
+    return out << mem.offset << "(" << mem.reg << ")";
+}
+inline OutputBuffer& operator<<(OutputBuffer& out, const ClassLabel& label) {
+    return out << label.cls << label.suffix;
+}
+inline OutputBuffer& operator<<(OutputBuffer& out, const MethodLabel& label) {
+    return out << label.cls << "." << label.method;
+}
+inline OutputBuffer& operator<<(OutputBuffer& out, const NumberedLabel& label) {
+    return out << label.prefix << label.number;
+}
+
+// MIPS assembly as spim reads it, laid out like the output of the reference
+// cgen: one instruction or directive per line, a tab before the opcode and
+// after it, operands separated by blanks. Everything goes through a single
+// OutputBuffer.
+class Emitter {
+   public:
+    explicit Emitter(OutputBuffer& out) : out_(out) {}
+
+    template <class... Operands>
+    void Op(std::string_view op, const Operands&... operands) {
+        out_ << '\t' << op;
+        if constexpr (sizeof...(Operands) > 0) {
+            std::string_view separator = "\t";
+            ((out_ << separator << operands, separator = " "), ...);
+        }
+        out_ << '\n';
+    }
+
+    template <class T>
+    void Label(const T& label) {
+        out_ << label << ":" << '\n';
+    }
+
+    template <class T>
+    void Global(const T& label) {
+        Op(".globl", label);
+    }
+
+    template <class T>
+    void Word(const T& value) {
+        Op(".word", value);
+    }
+
+    // `text` as the bytes of a string constant, without the terminating 0
+    void Ascii(std::string_view text);
+
+   private:
+    OutputBuffer& out_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "parser/syntax.h"
+
+// Children of a node in the order the generated code evaluates them: the
+// arguments of a dispatch before its object, the rest as Child lists them.
+const Expression* EvaluationChild(const Expression& expr, std::size_t idx);
+
+// Where the values a method keeps for a while live: the left operand of an
+// arithmetic, comparison or equality while the right one is computed, and
+// the names bound by lets and case branches.
+//
+// Every such value is a live interval over the nodes of the method in the
+// order they are evaluated, and intervals get registers by linear scan.
+// The runtime routines only use $t0-$t4, so an interval that spans no call
+// of a method of the program can go in $t5-$t9; the others need $s1-$s7,
+// which a method saves in its frame when it uses them. When no register is
+// free the interval that ends last is spilled: a temporary to the stack, as
+// by the stack machine, a binding to a slot of the frame.
+class RegisterAllocator {
+   public:
+    // a register, or the stack (temporaries) or a frame slot (bindings)
+    struct Location {
+        // empty if spilled
+        std::string_view reg;
+        // of a spilled binding, from $fp
+        int32_t offset = 0;
+    };
+
+    // false leaves every value in memory, the code of a plain stack machine
+    explicit RegisterAllocator(bool enabled = true) : enabled_(enabled) {}
+
+    // Adds the values of `body`, as if evaluated after the bodies added
+    // before it: the attribute initializations of a class share a frame.
+    void Add(const Expression& body);
+    void Allocate();
+
+    // of the binary operator, let, or case branch body `node`
+    const Location& Find(const Expression& node) const { return locations_.at(&node); }
+    // frame slots taken by spilled bindings
+    std::size_t SlotCount() const { return slotCount_; }
+    // the $s registers in use, saved by the method
+    const std::vector<std::string_view>& SavedRegisters() const { return saved_; }
+
+   private:
+    struct Interval {
+        const Expression* node;
+        std::size_t start;
+        std::size_t end = 0;
+        // a binding, which is spilled to the frame rather than the stack
+        bool binding;
+        bool acrossCalls = false;
+    };
+
+    class Collector;
+
+    // opens the interval of `node` at the current position
+    void Open(const Expression& node, bool binding);
+    // closes the innermost open interval
+    void Close();
+
+   private:
+    const bool enabled_;
+    std::vector<Interval> intervals_;
+    std::vector<std::size_t> open_;
+    // positions of the calls of methods of the program and of init methods
+    std::vector<std::size_t> calls_;
+    std::size_t position_ = 0;
+
+    std::unordered_map<const Expression*, Location> locations_;
+    std::size_t slotCount_ = 0;
+    std::vector<std::string_view> saved_;
+};
@@ -0,0 +1,749 @@
+#include "cgen/code_generator.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "cgen/register_allocator.h"
+#include "parser/visitor.h"
+#include "semant/scope.h"
+
+namespace {
+
+using ClassId = ClassGraph::ClassId;
+
+// words of an object before its attributes: tag, size, dispatch table
+const int32_t HEADER_WORDS = 3;
+// an object's attribute `offset`, relative to the object
+int32_t AttributeAddress(uint32_t offset) {
+    return 4 * (HEADER_WORDS + offset);
+}
+
+// the frame is the slots of spilled bindings and the saved $s registers,
+// then $ra, $s0, $fp, then arguments
+const int32_t SAVED_WORDS = 3;
+
+// interned once, methods of different classes may be generated from
+// different threads some day
+struct Names {
+    Symbol selfType = "SELF_TYPE";
+    Symbol self = "self";
+    Symbol object = "Object";
+    Symbol integer = "Int";
+    Symbol boolean = "Bool";
+    Symbol string = "String";
+    Symbol main = "Main";
+    Symbol mainMethod = "main";
+};
+
+const Names& names() {
+    static const Names names;
+    return names;
+}
+
+// The code of one method body or attribute initialization. Children are
+// walked in the order they are evaluated; what goes between two of them
+// is emitted by Child, what follows the last one by Leave.
+class ExpressionGenerator {
+   public:
+    using Location = RegisterAllocator::Location;
+
+    struct State {
+        // the first of the labels the node has taken
+        std::size_t label = 0;
+    };
+
+    ExpressionGenerator(const CodeGenerator& generator, Emitter& emitter, ClassId id,
+                        const RegisterAllocator& allocator, std::size_t& labels)
+        : generator_(generator),
+          emitter_(emitter),
+          id_(id),
+          cls_(generator.Graph().GetClass(id)),
+          allocator_(allocator),
+          labels_(labels) {}
+
+    // a formal, at a fixed offset from $fp
+    void Bind(Symbol name, int32_t offset) { scope_.Bind(name, Location{std::string_view(), offset}); }
+
+    void Generate(const Expression& expr) { Walk(expr, State(), *this); }
+
+    const Expression* ChildAt(const Expression& expr, std::size_t idx) { return EvaluationChild(expr, idx); }
+
+    void Enter(const Expression& expr, State& state) {
+        std::visit(overloaded{
+                       [&](const CondExpr&) { state.label = NewLabels(2); },
+                       [&](const WhileExpr&) {
+                           state.label = NewLabels(2);
+                           emitter_.Label(Label(state.label));
+                       },
+                       [&](const Case& node) {
+                           // the end, then an entry and a miss for every branch
+                           state.label = NewLabels(1 + 2 * node.branches.size());
+                       },
+                       [&](const DispatchExpr&) { state.label = NewLabels(1); },
+                       [&](const auto&) {},
+                   },
+                   expr.data_);
+    }
+
+    State Child(const Expression& expr, std::size_t idx, State& state) {
+        std::visit(overloaded{
+                       [&](const CondExpr&) {
+                           if (idx == 1) {
+                               emitter_.Op("lw", "$t1", Mem{12, "$a0"});
+                               emitter_.Op("beqz", "$t1", Label(state.label));
+                           } else if (idx == 2) {
+                               emitter_.Op("b", Label(state.label + 1));
+                               emitter_.Label(Label(state.label));
+                           }
+                       },
+                       [&](const WhileExpr&) {
+                           if (idx == 1) {
+                               emitter_.Op("lw", "$t1", Mem{12, "$a0"});
+                               emitter_.Op("beqz", "$t1", Label(state.label + 1));
+                           }
+                       },
+                       [&](const LetExpr& node) {
+                           if (idx == 1) {
+                               if (std::holds_alternative<NoExpr>(node.expr->data_)) {
+                                   generator_.EmitDefault(emitter_, node.type.value);
+                               }
+                               const Location& location = allocator_.Find(expr);
+                               Store(location);
+                               scope_.Bind(node.id.value, location);
+                           }
+                       },
+                       [&](const Case& node) {
+                           if (idx == 1) {
+                               Dispatch(node, state);
+                           } else if (idx > 1) {
+                               emitter_.Op("b", Label(state.label));
+                               scope_.Unbind();
+                           }
+                           if (idx > 0) {
+                               const BranchExpr& branch = *node.branches[idx - 1];
+                               const Location& location = allocator_.Find(*branch.expr);
+                               emitter_.Label(Label(state.label + 2 * idx - 1));
+                               Store(location);
+                               scope_.Bind(branch.id.value, location);
+                           }
+                       },
+                       [&](const DispatchExpr&) {
+                           if (idx > 0) {
+                               Push();
+                           }
+                       },
+                       [&](const auto& node) {
+                           // the left operand waits in its register or on the stack;
+                           // a constant or a name is loaded right into the register
+                           if constexpr (std::is_base_of_v<BinaryExpr, std::decay_t<decltype(node)>>) {
+                               const Location& location = allocator_.Find(expr);
+                               if (idx == 0 && !location.reg.empty() && IsLeaf(*node.lhs)) {
+                                   result_ = location.reg;
+                               } else if (idx == 1 && location.reg.empty()) {
+                                   Push();
+                               } else if (idx == 1 && !IsLeaf(*node.lhs)) {
+                                   emitter_.Op("move", location.reg, "$a0");
+                               }
+                           }
+                       },
+                   },
+                   expr.data_);
+        return State();
+    }
+
+    void Leave(const Expression& expr, State& state) {
+        const Names& n = names();
+        std::visit(overloaded{
+                       [&](const IntExpr& node) {
+                           emitter_.Op("la", Result(), NumberedLabel{"int_const", generator_.IntConstant(node.value)});
+                       },
+                       [&](const StringExpr& node) {
+                           emitter_.Op("la", Result(), NumberedLabel{"str_const", generator_.StringConstant(node.value)});
+                       },
+                       [&](const BoolExpr& node) { emitter_.Op("la", Result(), node.value ? "bool_const1" : "bool_const0"); },
+                       [&](const IdentifierExpr& node) {
+                           if (node.value == n.self) {
+                               emitter_.Op("move", Result(), "$s0");
+                           } else if (const Location* location = scope_.Find(node.value)) {
+                               Load(Result(), *location);
+                           } else {
+                               emitter_.Op("lw", Result(), Mem{Attribute(node.value), "$s0"});
+                           }
+                       },
+                       [&](const AssignExpr& node) {
+                           if (const Location* location = scope_.Find(node.id.value)) {
+                               Store(*location);
+                           } else {
+                               emitter_.Op("sw", "$a0", Mem{Attribute(node.id.value), "$s0"});
+                           }
+                       },
+                       [&](const NewExpr& node) { New(node.type.value); },
+                       [&](const NoExpr&) { emitter_.Op("move", "$a0", "$zero"); },
+                       [&](const IsVoidExpr&) {
+                           emitter_.Op("move", "$t1", "$a0");
+                           Select("beqz", "$t1", nullptr);
+                       },
+                       [&](const NotExpr&) {
+                           emitter_.Op("lw", "$t1", Mem{12, "$a0"});
+                           Select("beqz", "$t1", nullptr);
+                       },
+                       [&](const NegExpr&) {
+                           emitter_.Op("jal", "Object.copy");
+                           emitter_.Op("lw", "$t1", Mem{12, "$a0"});
+                           emitter_.Op("neg", "$t1", "$t1");
+                           emitter_.Op("sw", "$t1", Mem{12, "$a0"});
+                       },
+                       [&](const PlusExpr&) { Arithmetic(expr, "add"); },
+                       [&](const SubExpr&) { Arithmetic(expr, "sub"); },
+                       [&](const MulExpr&) { Arithmetic(expr, "mul"); },
+                       [&](const DivExpr&) { Arithmetic(expr, "div"); },
+                       [&](const LessExpr&) { Compare(expr, "blt"); },
+                       [&](const LeExpr&) { Compare(expr, "ble"); },
+                       [&](const EqExpr&) {
+                           LeftOperand(expr, "$t1");
+                           emitter_.Op("move", "$t2", "$a0");
+                           const std::size_t done = NewLabels(1);
+                           emitter_.Op("la", "$a0", "bool_const1");
+                           emitter_.Op("beq", "$t1", "$t2", Label(done));
+                           emitter_.Op("la", "$a1", "bool_const0");
+                           emitter_.Op("jal", "equality_test");
+                           emitter_.Label(Label(done));
+                       },
+                       [&](const CondExpr&) { emitter_.Label(Label(state.label + 1)); },
+                       [&](const WhileExpr&) {
+                           emitter_.Op("b", Label(state.label));
+                           emitter_.Label(Label(state.label + 1));
+                           emitter_.Op("move", "$a0", "$zero");
+                       },
+                       [&](const BlockExpr&) {},
+                       [&](const LetExpr&) { scope_.Unbind(); },
+                       [&](const Case&) {
+                           scope_.Unbind();
+                           emitter_.Label(Label(state.label));
+                       },
+                       [&](const DispatchExpr& node) { Call(node, expr.lineOfCode, state); },
+                   },
+                   expr.data_);
+    }
+
+   private:
+    NumberedLabel Label(std::size_t number) const { return NumberedLabel{"label", number}; }
+
+    std::size_t NewLabels(std::size_t count) {
+        const std::size_t first = labels_;
+        labels_ += count;
+        return first;
+    }
+
+    // constants and names, which need no register to be computed
+    static bool IsLeaf(const Expression& expr) {
+        return std::holds_alternative<IntExpr>(expr.data_) || std::holds_alternative<StringExpr>(expr.data_) ||
+               std::holds_alternative<BoolExpr>(expr.data_) || std::holds_alternative<IdentifierExpr>(expr.data_);
+    }
+
+    // where a leaf puts its value: $a0, or the register of the left operand
+    // it is
+    std::string_view Result() { return std::exchange(result_, "$a0"); }
+
+    int32_t Attribute(Symbol name) const {
+        return AttributeAddress(generator_.Layout().AttributeOffset(id_, name));
+    }
+
+    void Push() {
+        emitter_.Op("sw", "$a0", Mem{0, "$sp"});
+        emitter_.Op("addiu", "$sp", "$sp", -4);
+    }
+
+    void Pop(std::string_view reg) {
+        emitter_.Op("lw", reg, Mem{4, "$sp"});
+        emitter_.Op("addiu", "$sp", "$sp", 4);
+    }
+
+    // a binding, from its register or its frame slot
+    void Load(std::string_view reg, const Location& location) {
+        if (location.reg.empty()) {
+            emitter_.Op("lw", reg, Mem{location.offset, "$fp"});
+        } else {
+            emitter_.Op("move", reg, location.reg);
+        }
+    }
+
+    void Store(const Location& location) {
+        if (location.reg.empty()) {
+            emitter_.Op("sw", "$a0", Mem{location.offset, "$fp"});
+        } else {
+            emitter_.Op("move", location.reg, "$a0");
+        }
+    }
+
+    // the left operand of binary `expr` into `reg`
+    void LeftOperand(const Expression& expr, std::string_view reg) {
+        const Location& location = allocator_.Find(expr);
+        if (location.reg.empty()) {
+            Pop(reg);
+        } else {
+            emitter_.Op("move", reg, location.reg);
+        }
+    }
+
+    // the Int value of the left operand of `expr` into $t1
+    void LeftValue(const Expression& expr) {
+        const Location& location = allocator_.Find(expr);
+        if (location.reg.empty()) {
+            Pop("$t1");
+            emitter_.Op("lw", "$t1", Mem{12, "$t1"});
+        } else {
+            emitter_.Op("lw", "$t1", Mem{12, location.reg});
+        }
+    }
+
+    // $a0 is true if `branch lhs rhs` jumps, false otherwise
+    void Select(std::string_view branch, std::string_view lhs, const char* rhs) {
+        const std::size_t done = NewLabels(1);
+        emitter_.Op("la", "$a0", "bool_const1");
+        if (rhs) {
+            emitter_.Op(branch, lhs, rhs, Label(done));
+        } else {
+            emitter_.Op(branch, lhs, Label(done));
+        }
+        emitter_.Op("la", "$a0", "bool_const0");
+        emitter_.Label(Label(done));
+    }
+
+    // the result is a fresh copy of the right operand
+    void Arithmetic(const Expression& expr, std::string_view op) {
+        emitter_.Op("jal", "Object.copy");
+        LeftValue(expr);
+        emitter_.Op("lw", "$t2", Mem{12, "$a0"});
+        emitter_.Op(op, "$t1", "$t1", "$t2");
+        emitter_.Op("sw", "$t1", Mem{12, "$a0"});
+    }
+
+    void Compare(const Expression& expr, std::string_view branch) {
+        LeftValue(expr);
+        emitter_.Op("lw", "$t2", Mem{12, "$a0"});
+        Select(branch, "$t1", "$t2");
+    }
+
+    void New(Symbol type) {
+        if (type != names().selfType) {
+            emitter_.Op("la", "$a0", ClassLabel{type, "_protObj"});
+            emitter_.Op("jal", "Object.copy");
+            emitter_.Op("jal", ClassLabel{type, "_init"});
+            return;
+        }
+        // the prototype and init method of the class of self, from the
+        // class_objTab entry of its tag
+        emitter_.Op("la", "$t1", "class_objTab");
+        emitter_.Op("lw", "$t2", Mem{0, "$s0"});
+        emitter_.Op("sll", "$t2", "$t2", 3);
+        emitter_.Op("addu", "$t1", "$t1", "$t2");
+        emitter_.Op("sw", "$t1", Mem{0, "$sp"});
+        emitter_.Op("addiu", "$sp", "$sp", -4);
+        emitter_.Op("lw", "$a0", Mem{0, "$t1"});
+        emitter_.Op("jal", "Object.copy");
+        Pop("$t1");
+        emitter_.Op("lw", "$t1", Mem{4, "$t1"});
+        emitter_.Op("jalr", "$t1");
+    }
+
+    // stops with `routine` of the runtime if $a0 is void
+    void AbortIfVoid(std::size_t ok, std::string_view routine, std::size_t line) {
+        emitter_.Op("bne", "$a0", "$zero", Label(ok));
+        emitter_.Op("la", "$a0", NumberedLabel{"str_const", generator_.StringConstant(cls_.filename.view())});
+        emitter_.Op("li", "$t1", line);
+        emitter_.Op("jal", routine);
+        emitter_.Label(Label(ok));
+    }
+
+    // the scrutinee is in $a0: on to the branch of the closest ancestor of
+    // its class, the one with the narrowest range of tags that holds its tag
+    void Dispatch(const Case& node, const State& state) {
+        const std::size_t ok = NewLabels(1);
+        AbortIfVoid(ok, "_case_abort2", node.expr->lineOfCode);
+        std::vector<std::size_t> order(node.branches.size());
+        std::vector<ClassId> classes(node.branches.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+            classes[i] = generator_.Find(node.branches[i]->type.value);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return generator_.Depth(classes[lhs]) > generator_.Depth(classes[rhs]);
+        });
+        emitter_.Op("lw", "$t2", Mem{0, "$a0"});
+        for (const std::size_t i : order) {
+            const NumberedLabel miss = Label(state.label + 2 * (i + 1));
+            emitter_.Op("blt", "$t2", generator_.Tag(classes[i]), miss);
+            emitter_.Op("ble", "$t2", generator_.LastTag(classes[i]), Label(state.label + 2 * i + 1));
+            emitter_.Label(miss);
+        }
+        emitter_.Op("jal", "_case_abort");
+    }
+
+    void Call(const DispatchExpr& node, std::size_t line, const State& state) {
+        AbortIfVoid(state.label, "_dispatch_abort", line);
+        const bool isStatic = !node.type.value.empty();
+        const Symbol& type = isStatic ? node.type.value : node.obj->type;
+        const ClassId target = type == names().selfType ? id_ : generator_.Find(type);
+        const int32_t slot = 4 * generator_.Layout().MethodSlot(target, node.id.value);
+        if (isStatic) {
+            emitter_.Op("la", "$t1", ClassLabel{type, "_dispTab"});
+        } else {
+            emitter_.Op("lw", "$t1", Mem{8, "$a0"});
+        }
+        emitter_.Op("lw", "$t1", Mem{slot, "$t1"});
+        emitter_.Op("jalr", "$t1");
+    }
+
+   private:
+    const CodeGenerator& generator_;
+    Emitter& emitter_;
+    const ClassId id_;
+    const Class& cls_;
+    const RegisterAllocator& allocator_;
+    std::size_t& labels_;
+    // formals, lets and case branches
+    Scope<Location> scope_;
+    std::string_view result_ = "$a0";
+};
+
+// words of the frame below the saved $ra
+std::size_t LocalWords(const RegisterAllocator& allocator) {
+    return allocator.SlotCount() + allocator.SavedRegisters().size();
+}
+
+// the saved $s registers go right after the slots
+int32_t SavedRegisterAddress(const RegisterAllocator& allocator, std::size_t idx) {
+    return 4 * static_cast<int32_t>(allocator.SlotCount() + idx);
+}
+
+void EmitPrologue(Emitter& emitter, const RegisterAllocator& allocator) {
+    const int32_t frame = 4 * (LocalWords(allocator) + SAVED_WORDS);
+    emitter.Op("addiu", "$sp", "$sp", -frame);
+    emitter.Op("sw", "$fp", Mem{frame, "$sp"});
+    emitter.Op("sw", "$s0", Mem{frame - 4, "$sp"});
+    emitter.Op("sw", "$ra", Mem{frame - 8, "$sp"});
+    emitter.Op("addiu", "$fp", "$sp", 4);
+    emitter.Op("move", "$s0", "$a0");
+    const std::vector<std::string_view>& saved = allocator.SavedRegisters();
+    for (std::size_t i = 0; i < saved.size(); ++i) {
+        emitter.Op("sw", saved[i], Mem{SavedRegisterAddress(allocator, i), "$fp"});
+    }
+}
+
+void EmitEpilogue(Emitter& emitter, const RegisterAllocator& allocator, std::size_t arguments) {
+    const int32_t frame = 4 * (LocalWords(allocator) + SAVED_WORDS);
+    const std::vector<std::string_view>& saved = allocator.SavedRegisters();
+    for (std::size_t i = 0; i < saved.size(); ++i) {
+        emitter.Op("lw", saved[i], Mem{SavedRegisterAddress(allocator, i), "$fp"});
+    }
+    emitter.Op("lw", "$fp", Mem{frame, "$sp"});
+    emitter.Op("lw", "$s0", Mem{frame - 4, "$sp"});
+    emitter.Op("lw", "$ra", Mem{frame - 8, "$sp"});
+    emitter.Op("addiu", "$sp", "$sp", frame + 4 * static_cast<int32_t>(arguments));
+    emitter.Op("jr", "$ra");
+}
+
+}  // namespace
+
+CodeGenerator::CodeGenerator(const InheritanceAnalyzer& inheritance, const TypeChecker& checker,
+                             bool allocateRegisters)
+    : graph_(inheritance.Graph()),
+      hierarchy_(inheritance.Hierarchy()),
+      layout_(checker.Layout()),
+      firstClass_(inheritance.FirstClass()),
+      tags_(graph_.Size()),
+      lastTags_(graph_.Size()),
+      allocateRegisters_(allocateRegisters) {
+    const std::vector<ClassId>& order = hierarchy_.PreOrder();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        tags_[order[i]] = lastTags_[order[i]] = i;
+    }
+    // children come after their parents, so a reversed pre-order has every
+    // subtree done before its root is
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        const ClassId parent = graph_.Parent(*it);
+        if (parent != ClassGraph::NO_CLASS) {
+            lastTags_[parent] = std::max(lastTags_[parent], lastTags_[*it]);
+        }
+    }
+    names();
+    CollectConstants();
+}
+
+std::string CodeGenerator::Unescape(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            result += text[i];
+            continue;
+        }
+        const char next = text[++i];
+        switch (next) {
+            case 'n': result += '\n'; break;
+            case 't': result += '\t'; break;
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            default:
+                if (next >= '0' && next <= '7' && i + 2 < text.size()) {
+                    // \ooo, as the lexer writes other control characters
+                    result += static_cast<char>((next - '0') * 64 + (text[i + 1] - '0') * 8 + (text[i + 2] - '0'));
+                    i += 2;
+                } else {
+                    result += next;
+                }
+        }
+    }
+    return result;
+}
+
+std::size_t CodeGenerator::AddString(std::string text) {
+    AddInt(text.size());
+    const auto [it, added] = strings_.try_emplace(text, stringValues_.size());
+    if (added) {
+        stringValues_.push_back(std::move(text));
+    }
+    return it->second;
+}
+
+std::size_t CodeGenerator::AddInt(int32_t value) {
+    const auto [it, added] = ints_.try_emplace(value, intValues_.size());
+    if (added) {
+        intValues_.push_back(value);
+    }
+    return it->second;
+}
+
+void CodeGenerator::CollectConstants() {
+    // the defaults of Int and String slots
+    AddInt(0);
+    AddString("");
+    struct Collector {
+        struct State {};
+        void Enter(const Expression& expr, State&) {
+            if (const auto* node = std::get_if<IntExpr>(&expr.data_)) {
+                generator.AddInt(node->value);
+            } else if (const auto* node = std::get_if<StringExpr>(&expr.data_)) {
+                if (!generator.literals_.count(node->value)) {
+                    generator.literals_.emplace(node->value, generator.AddString(Unescape(node->value.view())));
+                }
+            }
+        }
+        State Child(const Expression&, std::size_t, State&) { return State(); }
+        void Leave(const Expression&, State&) {}
+
+        CodeGenerator& generator;
+    } collector{*this};
+
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        const Class& cls = graph_.GetClass(id);
+        // for type_name and the messages of the runtime
+        AddString(cls.id.value.str());
+        AddString(cls.filename.str());
+        for (const Feature* feature : cls.features) {
+            Walk(*feature->expr, Collector::State(), collector);
+        }
+    }
+}
+
+void CodeGenerator::EmitDefault(Emitter& emitter, Symbol type) const {
+    const Names& n = names();
+    if (type == n.integer) {
+        emitter.Op("la", "$a0", NumberedLabel{"int_const", IntConstant(0)});
+    } else if (type == n.string) {
+        emitter.Op("la", "$a0", NumberedLabel{"str_const", StringConstant(std::string_view())});
+    } else if (type == n.boolean) {
+        emitter.Op("la", "$a0", "bool_const0");
+    } else {
+        emitter.Op("move", "$a0", "$zero");
+    }
+}
+
+void CodeGenerator::Generate(OutputBuffer& out) {
+    Emitter emitter(out);
+    emitter.Op(".data");
+    emitter.Op(".align", 2);
+    EmitGlobals(emitter);
+    EmitConstants(emitter);
+    EmitClassTables(emitter);
+    EmitPrototypes(emitter);
+    // the heap starts after everything else
+    emitter.Global("heap_start");
+    emitter.Label("heap_start");
+    emitter.Word(0);
+
+    const Names& n = names();
+    emitter.Op(".text");
+    emitter.Global(ClassLabel{n.main, "_init"});
+    emitter.Global(ClassLabel{n.integer, "_init"});
+    emitter.Global(ClassLabel{n.string, "_init"});
+    emitter.Global(ClassLabel{n.boolean, "_init"});
+    emitter.Global(MethodLabel{n.main, n.mainMethod});
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        EmitInit(emitter, id);
+    }
+    // the methods of the basic classes are the runtime's
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        if (id < firstClass_) {
+            continue;
+        }
+        for (const Feature* feature : graph_.GetClass(id).features) {
+            if (!feature->isAttr) {
+                EmitMethod(emitter, id, *feature);
+            }
+        }
+    }
+}
+
+void CodeGenerator::EmitGlobals(Emitter& emitter) {
+    const Names& n = names();
+    emitter.Global("class_nameTab");
+    emitter.Global(ClassLabel{n.main, "_protObj"});
+    emitter.Global(ClassLabel{n.integer, "_protObj"});
+    emitter.Global(ClassLabel{n.string, "_protObj"});
+    emitter.Global("bool_const0");
+    emitter.Global("bool_const1");
+    emitter.Global("_int_tag");
+    emitter.Global("_bool_tag");
+    emitter.Global("_string_tag");
+    emitter.Label("_int_tag");
+    emitter.Word(Tag(Find(n.integer)));
+    emitter.Label("_bool_tag");
+    emitter.Word(Tag(Find(n.boolean)));
+    emitter.Label("_string_tag");
+    emitter.Word(Tag(Find(n.string)));
+    // no garbage collection
+    emitter.Global("_MemMgr_INITIALIZER");
+    emitter.Label("_MemMgr_INITIALIZER");
+    emitter.Word("_NoGC_Init");
+    emitter.Global("_MemMgr_COLLECTOR");
+    emitter.Label("_MemMgr_COLLECTOR");
+    emitter.Word("_NoGC_Collect");
+    emitter.Global("_MemMgr_TEST");
+    emitter.Label("_MemMgr_TEST");
+    emitter.Word(0);
+}
+
+void CodeGenerator::EmitConstants(Emitter& emitter) {
+    const Names& n = names();
+    // every object is preceded by a -1, for the garbage collector
+    for (std::size_t i = 0; i < stringValues_.size(); ++i) {
+        const std::string& text = stringValues_[i];
+        emitter.Word(-1);
+        emitter.Label(NumberedLabel{"str_const", i});
+        emitter.Word(Tag(Find(n.string)));
+        emitter.Word(HEADER_WORDS + 1 + (text.size() + 4) / 4);
+        emitter.Word(ClassLabel{n.string, "_dispTab"});
+        emitter.Word(NumberedLabel{"int_const", IntConstant(text.size())});
+        emitter.Ascii(text);
+        emitter.Op(".byte", 0);
+        emitter.Op(".align", 2);
+    }
+    for (std::size_t i = 0; i < intValues_.size(); ++i) {
+        emitter.Word(-1);
+        emitter.Label(NumberedLabel{"int_const", i});
+        emitter.Word(Tag(Find(n.integer)));
+        emitter.Word(HEADER_WORDS + 1);
+        emitter.Word(ClassLabel{n.integer, "_dispTab"});
+        emitter.Word(intValues_[i]);
+    }
+    for (const int value : {0, 1}) {
+        emitter.Word(-1);
+        emitter.Label(NumberedLabel{"bool_const", static_cast<std::size_t>(value)});
+        emitter.Word(Tag(Find(n.boolean)));
+        emitter.Word(HEADER_WORDS + 1);
+        emitter.Word(ClassLabel{n.boolean, "_dispTab"});
+        emitter.Word(value);
+    }
+}
+
+void CodeGenerator::EmitClassTables(Emitter& emitter) {
+    // both by tag, that is in pre-order
+    emitter.Label("class_nameTab");
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        emitter.Word(NumberedLabel{"str_const", StringConstant(graph_.GetClass(id).id.value.view())});
+    }
+    emitter.Label("class_objTab");
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        const Symbol& name = graph_.GetClass(id).id.value;
+        emitter.Word(ClassLabel{name, "_protObj"});
+        emitter.Word(ClassLabel{name, "_init"});
+    }
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        emitter.Label(ClassLabel{graph_.GetClass(id).id.value, "_dispTab"});
+        for (const ClassLayout::Entry& entry : layout_.Methods(id)) {
+            emitter.Word(MethodLabel{graph_.GetClass(entry.owner).id.value, entry.feature->id.value});
+        }
+    }
+}
+
+void CodeGenerator::EmitPrototypes(Emitter& emitter) {
+    const Names& n = names();
+    for (const ClassId id : hierarchy_.PreOrder()) {
+        const Symbol& name = graph_.GetClass(id).id.value;
+        const auto attributes = layout_.Attributes(id);
+        emitter.Word(-1);
+        emitter.Label(ClassLabel{name, "_protObj"});
+        emitter.Word(Tag(id));
+        emitter.Word(HEADER_WORDS + attributes.size());
+        emitter.Word(ClassLabel{name, "_dispTab"});
+        for (const ClassLayout::Entry& entry : attributes) {
+            const Symbol& type = entry.feature->type.value;
+            if (type == n.integer) {
+                emitter.Word(NumberedLabel{"int_const", IntConstant(0)});
+            } else if (type == n.string) {
+                emitter.Word(NumberedLabel{"str_const", StringConstant(std::string_view())});
+            } else if (type == n.boolean) {
+                emitter.Word("bool_const0");
+            } else {
+                // void, and the raw values of Int, Bool and String
+                emitter.Word(0);
+            }
+        }
+    }
+}
+
+void CodeGenerator::EmitInit(Emitter& emitter, ClassId id) {
+    const Class& cls = graph_.GetClass(id);
+    RegisterAllocator allocator(allocateRegisters_);
+    for (const Feature* feature : cls.features) {
+        if (feature->isAttr) {
+            allocator.Add(*feature->expr);
+        }
+    }
+    allocator.Allocate();
+    emitter.Label(ClassLabel{cls.id.value, "_init"});
+    EmitPrologue(emitter, allocator);
+    const ClassId parent = graph_.Parent(id);
+    if (parent != ClassGraph::NO_CLASS) {
+        emitter.Op("jal", ClassLabel{graph_.GetClass(parent).id.value, "_init"});
+    }
+    for (const Feature* feature : cls.features) {
+        if (!feature->isAttr || std::holds_alternative<NoExpr>(feature->expr->data_)) {
+            continue;
+        }
+        ExpressionGenerator generator(*this, emitter, id, allocator, labels_);
+        generator.Generate(*feature->expr);
+        emitter.Op("sw", "$a0", Mem{AttributeAddress(layout_.AttributeOffset(id, feature->id.value)), "$s0"});
+    }
+    emitter.Op("move", "$a0", "$s0");
+    EmitEpilogue(emitter, allocator, 0);
+}
+
+void CodeGenerator::EmitMethod(Emitter& emitter, ClassId id, const Feature& method) {
+    RegisterAllocator allocator(allocateRegisters_);
+    allocator.Add(*method.expr);
+    allocator.Allocate();
+    emitter.Label(MethodLabel{graph_.GetClass(id).id.value, method.id.value});
+    EmitPrologue(emitter, allocator);
+    ExpressionGenerator generator(*this, emitter, id, allocator, labels_);
+    const std::size_t count = method.arguments.size();
+    const std::size_t words = LocalWords(allocator) + SAVED_WORDS;
+    for (std::size_t i = 0; i < count; ++i) {
+        generator.Bind(method.arguments[i].id.value, 4 * (words + count - 1 - i));
+    }
+    generator.Generate(*method.expr);
+    EmitEpilogue(emitter, allocator, count);
+}
@@ -0,0 +1,25 @@
+#include "cgen/emitter.h"
+
+void Emitter::Ascii(std::string_view text) {
+    // printable runs go in quotes, anything else byte by byte
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        std::size_t end = begin;
+        while (end < text.size() && text[end] >= ' ' && text[end] <= '~') {
+            ++end;
+        }
+        if (end > begin) {
+            out_ << '\t' << ".ascii" << '\t' << '"';
+            for (std::size_t i = begin; i < end; ++i) {
+                if (text[i] == '"' || text[i] == '\\') {
+                    out_ << '\\';
+                }
+                out_ << text[i];
+            }
+            out_ << '"' << '\n';
+            begin = end;
+        } else {
+            Op(".byte", static_cast<int>(static_cast<unsigned char>(text[begin++])));
+        }
+    }
+}
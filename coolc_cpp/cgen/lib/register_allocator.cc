@@ -0,0 +1,171 @@
+#include "cgen/register_allocator.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "parser/visitor.h"
+
+namespace {
+
+// safe across the runtime routines, not across methods of the program
+const std::string_view TEMPORARY_REGISTERS[] = {"$t5", "$t6", "$t7", "$t8", "$t9"};
+// saved by every method that uses them
+const std::string_view SAVED_REGISTERS[] = {"$s1", "$s2", "$s3", "$s4", "$s5", "$s6", "$s7"};
+
+bool IsSaved(std::string_view reg) {
+    return reg[1] == 's';
+}
+
+}  // namespace
+
+const Expression* EvaluationChild(const Expression& expr, std::size_t idx) {
+    if (const auto* dispatch = std::get_if<DispatchExpr>(&expr.data_)) {
+        return idx < dispatch->arguments.size() ? dispatch->arguments[idx] : dispatch->obj;
+    }
+    return Child(expr, idx);
+}
+
+// Numbers the nodes in evaluation order, a position before and after each
+// child, and opens and closes the intervals where the generated code stores
+// and drops the values.
+class RegisterAllocator::Collector {
+   public:
+    struct State {};
+
+    explicit Collector(RegisterAllocator& allocator) : allocator_(allocator) {}
+
+    const Expression* ChildAt(const Expression& expr, std::size_t idx) { return EvaluationChild(expr, idx); }
+
+    void Enter(const Expression&, State&) { ++allocator_.position_; }
+
+    State Child(const Expression& expr, std::size_t idx, State&) {
+        ++allocator_.position_;
+        std::visit(overloaded{
+                       [&](const LetExpr&) {
+                           if (idx == 1) {
+                               allocator_.Open(expr, true);
+                           }
+                       },
+                       [&](const Case& node) {
+                           if (idx > 1) {
+                               allocator_.Close();
+                           }
+                           if (idx > 0) {
+                               allocator_.Open(*node.branches[idx - 1]->expr, true);
+                           }
+                       },
+                       [&](const auto& node) {
+                           if constexpr (std::is_base_of_v<BinaryExpr, std::decay_t<decltype(node)>>) {
+                               if (idx == 1) {
+                                   allocator_.Open(expr, false);
+                               }
+                           }
+                       },
+                   },
+                   expr.data_);
+        return State();
+    }
+
+    void Leave(const Expression& expr, State&) {
+        ++allocator_.position_;
+        std::visit(overloaded{
+                       [&](const LetExpr&) { allocator_.Close(); },
+                       [&](const Case&) { allocator_.Close(); },
+                       [&](const DispatchExpr&) { allocator_.calls_.push_back(allocator_.position_); },
+                       // the init method of the class
+                       [&](const NewExpr&) { allocator_.calls_.push_back(allocator_.position_); },
+                       [&](const auto& node) {
+                           if constexpr (std::is_base_of_v<BinaryExpr, std::decay_t<decltype(node)>>) {
+                               allocator_.Close();
+                           }
+                       },
+                   },
+                   expr.data_);
+    }
+
+   private:
+    RegisterAllocator& allocator_;
+};
+
+void RegisterAllocator::Open(const Expression& node, bool binding) {
+    open_.push_back(intervals_.size());
+    intervals_.push_back(Interval{&node, position_, 0, binding});
+}
+
+void RegisterAllocator::Close() {
+    intervals_[open_.back()].end = position_;
+    open_.pop_back();
+}
+
+void RegisterAllocator::Add(const Expression& body) {
+    Collector collector(*this);
+    Walk(body, Collector::State(), collector);
+}
+
+void RegisterAllocator::Allocate() {
+    // opened in order of their starts, and the calls are in order too
+    for (Interval& interval : intervals_) {
+        const auto call = std::upper_bound(calls_.begin(), calls_.end(), interval.start);
+        interval.acrossCalls = call != calls_.end() && *call < interval.end;
+    }
+
+    std::vector<std::string_view> temporaries(std::rbegin(TEMPORARY_REGISTERS), std::rend(TEMPORARY_REGISTERS));
+    std::vector<std::string_view> saved(std::rbegin(SAVED_REGISTERS), std::rend(SAVED_REGISTERS));
+    const auto release = [&](std::string_view reg) { (IsSaved(reg) ? saved : temporaries).push_back(reg); };
+    // intervals with a register, by increasing end
+    std::vector<std::size_t> active;
+    std::vector<std::string_view> registers(intervals_.size());
+    for (std::size_t i = 0; enabled_ && i < intervals_.size(); ++i) {
+        const Interval& interval = intervals_[i];
+        while (!active.empty() && intervals_[active.front()].end < interval.start) {
+            release(registers[active.front()]);
+            active.erase(active.begin());
+        }
+        if (!interval.acrossCalls && !temporaries.empty()) {
+            registers[i] = temporaries.back();
+            temporaries.pop_back();
+        } else if (!saved.empty()) {
+            registers[i] = saved.back();
+            saved.pop_back();
+        } else {
+            // the register of the interval that ends last, if it outlives
+            // this one and this one may use it
+            const auto victim = std::find_if(active.rbegin(), active.rend(), [&](std::size_t other) {
+                return !interval.acrossCalls || IsSaved(registers[other]);
+            });
+            if (victim == active.rend() || intervals_[*victim].end < interval.end) {
+                continue;
+            }
+            registers[i] = registers[*victim];
+            registers[*victim] = std::string_view();
+            active.erase(std::next(victim).base());
+        }
+        const auto at = std::upper_bound(active.begin(), active.end(), interval.end,
+                                         [&](std::size_t end, std::size_t other) { return end < intervals_[other].end; });
+        active.insert(at, i);
+    }
+
+    // spilled bindings nest, a slot is free again once its binding ends
+    std::vector<std::size_t> slots;
+    for (std::size_t i = 0; i < intervals_.size(); ++i) {
+        const Interval& interval = intervals_[i];
+        Location& location = locations_[interval.node];
+        location.reg = registers[i];
+        if (!registers[i].empty()) {
+            if (IsSaved(registers[i]) && std::find(saved_.begin(), saved_.end(), registers[i]) == saved_.end()) {
+                saved_.push_back(registers[i]);
+            }
+            continue;
+        }
+        if (!interval.binding) {
+            continue;
+        }
+        while (!slots.empty() && intervals_[slots.back()].end < interval.start) {
+            slots.pop_back();
+        }
+        location.offset = 4 * static_cast<int32_t>(slots.size());
+        slots.push_back(i);
+        slotCount_ = std::max(slotCount_, slots.size());
+    }
+    std::sort(saved_.begin(), saved_.end());
+}
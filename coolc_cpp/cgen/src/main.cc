@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "cgen/code_generator.h"
+#include "parser/output_buffer.h"
+#include "parser/syntax.h"
+#include "semant/inheritance.h"
+#include "semant/type_checker.h"
+
+void usage() {
+    std::cerr << "Usage: ./cgen [-s]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // -s: no register allocation, every value on the stack or in the frame
+    bool stackOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-s") {
+            stackOnly = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    // the typed AST semant prints; checked again for the tables and types
+    // code generation needs
+    Program program = ReadProgram();
+    InheritanceAnalyzer inherAnalyzer(program);
+    if (!inherAnalyzer.checkCorrectness()) {
+        std::cerr << "Compilation halted due to static semantic errors." << std::endl;
+        return 1;
+    }
+    TypeChecker typeChecker(inherAnalyzer);
+    if (!typeChecker.Check()) {
+        std::cerr << "Compilation halted due to static semantic errors." << std::endl;
+        return 1;
+    }
+    OutputBuffer out(stdout);
+    CodeGenerator(inherAnalyzer, typeChecker, !stackOnly).Generate(out);
+    return 0;
+}
@@ -0,0 +1,583 @@
+#include "mips_simulator.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+const uint32_t TEXT_BASE = 0x00400000;
+// addresses of the routines of the runtime, below the program
+const uint32_t RUNTIME_BASE = 0x00100000;
+const uint32_t DATA_BASE = 0x10000000;
+const uint32_t STACK_TOP = 0x7ffffffc;
+const uint32_t STACK_SIZE = 16 << 20;
+// where Main_init and Main.main return to
+const uint32_t EXIT = 0x4;
+// what a runtime routine leaves in the registers it may trash
+const uint32_t TRASH = 0xdeadbeef;
+
+const uint8_t SP = 29;
+const uint8_t RA = 31;
+
+const char* const ROUTINES[] = {
+    "Object.copy", "Object.abort", "Object.type_name", "IO.out_string", "IO.out_int", "IO.in_string",
+    "IO.in_int", "String.length", "String.concat", "String.substr", "equality_test", "_dispatch_abort",
+    "_case_abort", "_case_abort2", "_NoGC_Init", "_NoGC_Collect",
+};
+const std::size_t ROUTINE_COUNT = sizeof(ROUTINES) / sizeof(ROUTINES[0]);
+
+bool ParseRegister(std::string_view token, uint8_t& reg) {
+    static const std::unordered_map<std::string_view, uint8_t> registers = {
+        {"$zero", 0}, {"$at", 1}, {"$v0", 2},  {"$v1", 3},  {"$a0", 4},  {"$a1", 5},  {"$a2", 6},  {"$a3", 7},
+        {"$t0", 8},   {"$t1", 9}, {"$t2", 10}, {"$t3", 11}, {"$t4", 12}, {"$t5", 13}, {"$t6", 14}, {"$t7", 15},
+        {"$s0", 16},  {"$s1", 17}, {"$s2", 18}, {"$s3", 19}, {"$s4", 20}, {"$s5", 21}, {"$s6", 22}, {"$s7", 23},
+        {"$t8", 24},  {"$t9", 25}, {"$k0", 26}, {"$k1", 27}, {"$gp", 28}, {"$sp", 29}, {"$fp", 30}, {"$ra", 31},
+    };
+    const auto it = registers.find(token);
+    if (it == registers.end()) {
+        return false;
+    }
+    reg = it->second;
+    return true;
+}
+
+bool ParseNumber(std::string_view token, int32_t& value) {
+    const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc() && end == token.data() + token.size();
+}
+
+// 12($s0)
+bool ParseMemory(std::string_view token, int32_t& offset, uint8_t& reg) {
+    const std::size_t open = token.find('(');
+    if (open == std::string_view::npos || token.back() != ')') {
+        return false;
+    }
+    return ParseNumber(token.substr(0, open), offset) &&
+           ParseRegister(token.substr(open + 1, token.size() - open - 2), reg);
+}
+
+bool FitsImmediate(int32_t value) {
+    return value >= -32768 && value <= 32767;
+}
+
+std::vector<std::string_view> Tokens(std::string_view line) {
+    std::vector<std::string_view> tokens;
+    std::size_t i = 0;
+    while (i < line.size()) {
+        if (line[i] == ' ' || line[i] == '\t' || line[i] == ',') {
+            ++i;
+            continue;
+        }
+        if (line[i] == '#') {
+            break;
+        }
+        const std::size_t begin = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != ',') {
+            ++i;
+        }
+        tokens.push_back(line.substr(begin, i - begin));
+    }
+    return tokens;
+}
+
+}  // namespace
+
+bool MipsSimulator::Load(std::string_view assembly, std::string& error) {
+    for (std::size_t i = 0; i < ROUTINE_COUNT; ++i) {
+        labels_[ROUTINES[i]] = RUNTIME_BASE + 4 * i;
+    }
+    bool inText = false;
+    std::size_t lineNumber = 0;
+    while (!assembly.empty()) {
+        const std::size_t end = std::min(assembly.find('\n'), assembly.size());
+        std::string_view line = assembly.substr(0, end);
+        assembly.remove_prefix(std::min(end + 1, assembly.size()));
+        ++lineNumber;
+
+        // a label starts the line, everything else is indented
+        if (!line.empty() && line[0] != ' ' && line[0] != '\t' && line[0] != '#') {
+            const std::size_t colon = line.find(':');
+            if (colon == std::string_view::npos) {
+                error = "line " + std::to_string(lineNumber) + ": expected a label";
+                return false;
+            }
+            const std::string label(line.substr(0, colon));
+            const uint32_t address = inText ? TEXT_BASE + 4 * text_.size() : DATA_BASE + data_.size();
+            if (!labels_.emplace(label, address).second) {
+                error = "line " + std::to_string(lineNumber) + ": " + label + " defined twice";
+                return false;
+            }
+            line.remove_prefix(colon + 1);
+        }
+        const std::vector<std::string_view> tokens = Tokens(line);
+        if (tokens.empty()) {
+            continue;
+        }
+        if (tokens[0] == ".text" || tokens[0] == ".data") {
+            inText = tokens[0] == ".text";
+        } else if (tokens[0] == ".globl") {
+        } else if (tokens[0][0] == '.') {
+            if (!ParseData(tokens, line, lineNumber, error)) {
+                return false;
+            }
+        } else if (!inText) {
+            error = "line " + std::to_string(lineNumber) + ": an instruction in .data";
+            return false;
+        } else if (!ParseInstruction(tokens, lineNumber, error)) {
+            return false;
+        }
+    }
+
+    for (const Fixup& fixup : fixups_) {
+        const auto it = labels_.find(fixup.label);
+        if (it == labels_.end()) {
+            error = "line " + std::to_string(fixup.line) + ": undefined label " + fixup.label;
+            return false;
+        }
+        if (fixup.inText) {
+            text_[fixup.address].target = it->second;
+        } else {
+            std::memcpy(&data_[fixup.address - DATA_BASE], &it->second, 4);
+        }
+    }
+    return true;
+}
+
+bool MipsSimulator::ParseData(const std::vector<std::string_view>& tokens, std::string_view text,
+                              std::size_t line, std::string& error) {
+    const std::string where = "line " + std::to_string(line) + ": ";
+    const std::string_view directive = tokens[0];
+    int32_t value = 0;
+    if (directive == ".ascii" || directive == ".asciiz") {
+        const std::size_t begin = text.find('"');
+        const std::size_t end = text.rfind('"');
+        if (begin == end) {
+            error = where + "expected a string";
+            return false;
+        }
+        for (std::size_t i = begin + 1; i < end; ++i) {
+            char c = text[i];
+            if (c == '\\' && i + 1 < end) {
+                c = text[++i];
+                c = c == 'n' ? '\n' : c == 't' ? '\t' : c;
+            }
+            data_.push_back(c);
+        }
+        if (directive == ".asciiz") {
+            data_.push_back(0);
+        }
+        return true;
+    }
+    if (tokens.size() != 2) {
+        error = where + "expected one operand";
+        return false;
+    }
+    if (directive == ".align") {
+        if (!ParseNumber(tokens[1], value)) {
+            error = where + "bad alignment";
+            return false;
+        }
+        while (data_.size() % (1u << value)) {
+            data_.push_back(0);
+        }
+    } else if (directive == ".byte") {
+        if (!ParseNumber(tokens[1], value)) {
+            error = where + "bad byte";
+            return false;
+        }
+        data_.push_back(static_cast<uint8_t>(value));
+    } else if (directive == ".word") {
+        // spim aligns words itself
+        while (data_.size() % 4) {
+            data_.push_back(0);
+        }
+        if (!ParseNumber(tokens[1], value)) {
+            fixups_.push_back(Fixup{std::string(tokens[1]), static_cast<uint32_t>(DATA_BASE + data_.size()), false, line});
+        }
+        data_.resize(data_.size() + 4);
+        std::memcpy(&data_[data_.size() - 4], &value, 4);
+    } else {
+        error = where + "unknown directive " + std::string(directive);
+        return false;
+    }
+    return true;
+}
+
+bool MipsSimulator::ParseInstruction(const std::vector<std::string_view>& tokens, std::size_t line,
+                                     std::string& error) {
+    static const std::unordered_map<std::string_view, Op> ops = {
+        {"add", Op::Add},   {"addu", Op::Addu}, {"sub", Op::Sub},   {"subu", Op::Subu}, {"mul", Op::Mul},
+        {"div", Op::Div},   {"addiu", Op::Addiu}, {"sll", Op::Sll}, {"move", Op::Move}, {"neg", Op::Neg},
+        {"li", Op::Li},     {"la", Op::La},     {"lw", Op::Lw},     {"sw", Op::Sw},     {"b", Op::B},
+        {"beqz", Op::Beqz}, {"bnez", Op::Bnez}, {"beq", Op::Beq},   {"bne", Op::Bne},   {"blt", Op::Blt},
+        {"ble", Op::Ble},   {"bgt", Op::Bgt},   {"bge", Op::Bge},   {"jal", Op::Jal},   {"jalr", Op::Jalr},
+        {"jr", Op::Jr},
+    };
+    const std::string where = "line " + std::to_string(line) + ": ";
+    const auto it = ops.find(tokens[0]);
+    if (it == ops.end()) {
+        error = where + "unknown instruction " + std::string(tokens[0]);
+        return false;
+    }
+    Instruction instruction{it->second};
+    instruction.line = line;
+    const auto expect = [&](std::size_t count) {
+        if (tokens.size() != count + 1) {
+            error = where + "expected " + std::to_string(count) + " operands";
+            return false;
+        }
+        return true;
+    };
+    const auto reg = [&](std::size_t idx, uint8_t& to) {
+        if (!ParseRegister(tokens[idx], to)) {
+            error = where + "expected a register: " + std::string(tokens[idx]);
+            return false;
+        }
+        return true;
+    };
+    const auto number = [&](std::size_t idx) {
+        if (!ParseNumber(tokens[idx], instruction.imm)) {
+            error = where + "expected a number: " + std::string(tokens[idx]);
+            return false;
+        }
+        return true;
+    };
+    const auto label = [&](std::size_t idx) {
+        fixups_.push_back(Fixup{std::string(tokens[idx]), static_cast<uint32_t>(text_.size()), true, line});
+    };
+    // a register, or an immediate spim loads into $at first
+    const auto source = [&](std::size_t idx) {
+        if (ParseRegister(tokens[idx], instruction.rt)) {
+            return true;
+        }
+        instruction.immediate = true;
+        return number(idx);
+    };
+
+    bool ok = true;
+    switch (instruction.op) {
+        case Op::Add:
+        case Op::Addu:
+        case Op::Sub:
+        case Op::Subu:
+        case Op::Mul:
+        case Op::Div:
+            ok = expect(3) && reg(1, instruction.rd) && reg(2, instruction.rs) && reg(3, instruction.rt);
+            // bne over a break, div, mflo
+            instruction.weight = instruction.op == Op::Div ? 3 : 1;
+            break;
+        case Op::Addiu:
+        case Op::Sll:
+            ok = expect(3) && reg(1, instruction.rd) && reg(2, instruction.rs) && number(3);
+            break;
+        case Op::Move:
+        case Op::Neg:
+            ok = expect(2) && reg(1, instruction.rd) && reg(2, instruction.rs);
+            break;
+        case Op::Li:
+            ok = expect(2) && reg(1, instruction.rd) && number(2);
+            instruction.weight = FitsImmediate(instruction.imm) ? 1 : 2;
+            break;
+        case Op::La:
+            ok = expect(2) && reg(1, instruction.rd);
+            label(2);
+            // lui, ori
+            instruction.weight = 2;
+            break;
+        case Op::Lw:
+        case Op::Sw:
+            ok = expect(2) && reg(1, instruction.rd);
+            if (ok && !ParseMemory(tokens[2], instruction.imm, instruction.rs)) {
+                error = where + "expected an address: " + std::string(tokens[2]);
+                ok = false;
+            }
+            break;
+        case Op::B:
+        case Op::Jal:
+            ok = expect(1);
+            label(1);
+            break;
+        case Op::Beqz:
+        case Op::Bnez:
+            ok = expect(2) && reg(1, instruction.rs);
+            label(2);
+            break;
+        case Op::Beq:
+        case Op::Bne:
+        case Op::Blt:
+        case Op::Ble:
+        case Op::Bgt:
+        case Op::Bge:
+            ok = expect(3) && reg(1, instruction.rs) && source(2);
+            label(3);
+            if (instruction.op != Op::Beq && instruction.op != Op::Bne) {
+                // slt and a branch, after an li for ble and bgt
+                instruction.weight = instruction.immediate && (instruction.op == Op::Ble || instruction.op == Op::Bgt)
+                                         ? 3
+                                         : 2;
+            } else if (instruction.immediate) {
+                instruction.weight = 2;
+            }
+            break;
+        case Op::Jalr:
+        case Op::Jr:
+            ok = expect(1) && reg(1, instruction.rs);
+            break;
+    }
+    text_.push_back(instruction);
+    return ok;
+}
+
+uint32_t MipsSimulator::Word(uint32_t address) {
+    uint32_t value = 0;
+    if (address % 4) {
+        Stop("unaligned address " + std::to_string(address) + "\n");
+    } else if (address >= DATA_BASE && address - DATA_BASE + 4 <= data_.size()) {
+        std::memcpy(&value, &data_[address - DATA_BASE], 4);
+    } else if (address <= STACK_TOP && STACK_TOP - address <= stack_.size() - 4) {
+        std::memcpy(&value, &stack_[stack_.size() - 4 - (STACK_TOP - address)], 4);
+    } else {
+        Stop("bad address " + std::to_string(address) + "\n");
+    }
+    return value;
+}
+
+void MipsSimulator::SetWord(uint32_t address, uint32_t value) {
+    if (address % 4) {
+        Stop("unaligned address " + std::to_string(address) + "\n");
+    } else if (address >= DATA_BASE && address - DATA_BASE + 4 <= data_.size()) {
+        std::memcpy(&data_[address - DATA_BASE], &value, 4);
+    } else if (address <= STACK_TOP && STACK_TOP - address <= stack_.size() - 4) {
+        std::memcpy(&stack_[stack_.size() - 4 - (STACK_TOP - address)], &value, 4);
+    } else {
+        Stop("bad address " + std::to_string(address) + "\n");
+    }
+}
+
+uint32_t MipsSimulator::Allocate(uint32_t bytes) {
+    // the heap goes on after heap_start
+    const uint32_t address = DATA_BASE + data_.size();
+    data_.resize(data_.size() + bytes);
+    return address;
+}
+
+uint32_t MipsSimulator::Copy(uint32_t object) {
+    const uint32_t size = Word(object + 4);
+    if (stopped_) {
+        return 0;
+    }
+    const uint32_t copy = Allocate(4 * (size + 1)) + 4;
+    SetWord(copy - 4, -1);
+    for (uint32_t i = 0; i < size; ++i) {
+        SetWord(copy + 4 * i, Word(object + 4 * i));
+    }
+    return copy;
+}
+
+uint32_t MipsSimulator::NewInt(int32_t value) {
+    const uint32_t object = Copy(Label("Int_protObj"));
+    SetWord(object + 12, value);
+    return object;
+}
+
+uint32_t MipsSimulator::NewString(std::string_view text) {
+    const uint32_t prototype = Label("String_protObj");
+    const uint32_t length = NewInt(text.size());
+    const uint32_t size = 4 + (text.size() + 4) / 4;
+    const uint32_t object = Allocate(4 * (size + 1)) + 4;
+    SetWord(object - 4, -1);
+    SetWord(object, Word(prototype));
+    SetWord(object + 4, size);
+    SetWord(object + 8, Word(prototype + 8));
+    SetWord(object + 12, length);
+    std::memcpy(&data_[object + 16 - DATA_BASE], text.data(), text.size());
+    return object;
+}
+
+std::string MipsSimulator::String(uint32_t object) {
+    const uint32_t length = Word(Word(object + 12) + 12);
+    if (stopped_ || object < DATA_BASE || object - DATA_BASE + 16 + length > data_.size()) {
+        Stop("bad string\n");
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(&data_[object + 16 - DATA_BASE]), length);
+}
+
+std::string MipsSimulator::ClassName(uint32_t object) {
+    return String(Word(Label("class_nameTab") + 4 * Word(object)));
+}
+
+std::string MipsSimulator::ReadLine() {
+    const std::size_t end = std::min(input_.find('\n'), input_.size());
+    std::string line(input_.substr(0, end));
+    input_.remove_prefix(std::min(end + 1, input_.size()));
+    return line;
+}
+
+void MipsSimulator::Stop(std::string message) {
+    if (!stopped_) {
+        output_ += message;
+        stopped_ = true;
+    }
+}
+
+bool MipsSimulator::Routine(uint32_t address) {
+    uint32_t* r = registers_.data();
+    const std::string_view name = ROUTINES[(address - RUNTIME_BASE) / 4];
+    if (name == "Object.copy") {
+        r[4] = Copy(r[4]);
+    } else if (name == "Object.abort") {
+        Stop("Abort called from class " + ClassName(r[4]) + "\n");
+    } else if (name == "Object.type_name") {
+        r[4] = Word(Label("class_nameTab") + 4 * Word(r[4]));
+    } else if (name == "IO.out_string") {
+        output_ += String(Word(r[SP] + 4));
+        r[SP] += 4;
+    } else if (name == "IO.out_int") {
+        output_ += std::to_string(static_cast<int32_t>(Word(Word(r[SP] + 4) + 12)));
+        r[SP] += 4;
+    } else if (name == "IO.in_string") {
+        r[4] = NewString(ReadLine());
+    } else if (name == "IO.in_int") {
+        const std::string line = ReadLine();
+        const std::size_t begin = line.find_first_not_of(" \t");
+        int32_t value = 0;
+        if (begin != std::string::npos) {
+            std::from_chars(line.data() + begin, line.data() + line.size(), value);
+        }
+        r[4] = NewInt(value);
+    } else if (name == "String.length") {
+        r[4] = Word(r[4] + 12);
+    } else if (name == "String.concat") {
+        const std::string text = String(r[4]) + String(Word(r[SP] + 4));
+        r[SP] += 4;
+        r[4] = NewString(text);
+    } else if (name == "String.substr") {
+        const int32_t length = Word(Word(r[SP] + 4) + 12);
+        const int32_t index = Word(Word(r[SP] + 8) + 12);
+        const std::string text = String(r[4]);
+        r[SP] += 8;
+        if (index < 0 || length < 0 || static_cast<std::size_t>(index) + length > text.size()) {
+            Stop("Index to substr is out of range\n");
+        } else {
+            r[4] = NewString(std::string_view(text).substr(index, length));
+        }
+    } else if (name == "equality_test") {
+        const uint32_t lhs = r[9];
+        const uint32_t rhs = r[10];
+        bool equal = lhs == rhs;
+        if (!equal && lhs && rhs && Word(lhs) == Word(rhs)) {
+            const uint32_t tag = Word(lhs);
+            if (tag == Word(Label("_string_tag"))) {
+                equal = String(lhs) == String(rhs);
+            } else if (tag == Word(Label("_int_tag")) || tag == Word(Label("_bool_tag"))) {
+                equal = Word(lhs + 12) == Word(rhs + 12);
+            }
+        }
+        if (!equal) {
+            r[4] = r[5];
+        }
+    } else if (name == "_dispatch_abort") {
+        Stop(String(r[4]) + ":" + std::to_string(r[9]) + ": Dispatch to void.\n");
+    } else if (name == "_case_abort") {
+        Stop("No match in case statement for Class " + ClassName(r[4]) + "\n");
+    } else if (name == "_case_abort2") {
+        Stop(String(r[4]) + ":" + std::to_string(r[9]) + ": Match on void in case statement.\n");
+    }
+    for (const uint8_t trashed : {2, 3, 5, 6, 7, 8, 9, 10, 11, 12}) {
+        r[trashed] = TRASH;
+    }
+    return !stopped_;
+}
+
+std::string MipsSimulator::Run(std::string_view input, uint64_t limit) {
+    input_ = input;
+    stack_.assign(STACK_SIZE, 0);
+    registers_.fill(0);
+    uint32_t* r = registers_.data();
+    r[SP] = STACK_TOP;
+    r[30] = STACK_TOP;
+
+    const auto call = [&](uint32_t target) {
+        r[RA] = EXIT;
+        pc_ = target;
+        while (!stopped_ && pc_ != EXIT) {
+            if (pc_ >= RUNTIME_BASE && pc_ < RUNTIME_BASE + 4 * ROUTINE_COUNT) {
+                if (Routine(pc_)) {
+                    pc_ = r[RA];
+                }
+                continue;
+            }
+            if (pc_ < TEXT_BASE || pc_ - TEXT_BASE >= 4 * text_.size() || pc_ % 4) {
+                Stop("bad jump to " + std::to_string(pc_) + "\n");
+                break;
+            }
+            if (instructions_ >= limit) {
+                Stop("too many instructions\n");
+                break;
+            }
+            const Instruction& ins = text_[(pc_ - TEXT_BASE) / 4];
+            pc_ += 4;
+            instructions_ += ins.weight;
+            const uint32_t rs = r[ins.rs];
+            const uint32_t rt = ins.immediate ? ins.imm : r[ins.rt];
+            const auto branch = [&](bool taken) {
+                if (taken) {
+                    pc_ = ins.target;
+                }
+            };
+            const auto less = [](uint32_t lhs, uint32_t rhs) {
+                return static_cast<int32_t>(lhs) < static_cast<int32_t>(rhs);
+            };
+            switch (ins.op) {
+                case Op::Add:
+                case Op::Addu: r[ins.rd] = rs + rt; break;
+                case Op::Sub:
+                case Op::Subu: r[ins.rd] = rs - rt; break;
+                case Op::Mul: r[ins.rd] = static_cast<int32_t>(rs) * static_cast<int32_t>(rt); break;
+                case Op::Div:
+                    if (rt == 0) {
+                        Stop("division by zero\n");
+                    } else {
+                        r[ins.rd] = static_cast<int32_t>(rs) / static_cast<int32_t>(rt);
+                    }
+                    break;
+                case Op::Addiu: r[ins.rd] = rs + ins.imm; break;
+                case Op::Sll: r[ins.rd] = rs << ins.imm; break;
+                case Op::Move: r[ins.rd] = rs; break;
+                case Op::Neg: r[ins.rd] = -rs; break;
+                case Op::Li: r[ins.rd] = ins.imm; break;
+                case Op::La: r[ins.rd] = ins.target; break;
+                case Op::Lw: r[ins.rd] = Word(rs + ins.imm); break;
+                case Op::Sw: SetWord(rs + ins.imm, r[ins.rd]); break;
+                case Op::B: branch(true); break;
+                case Op::Beqz: branch(rs == 0); break;
+                case Op::Bnez: branch(rs != 0); break;
+                case Op::Beq: branch(rs == rt); break;
+                case Op::Bne: branch(rs != rt); break;
+                case Op::Blt: branch(less(rs, rt)); break;
+                case Op::Ble: branch(!less(rt, rs)); break;
+                case Op::Bgt: branch(less(rt, rs)); break;
+                case Op::Bge: branch(!less(rs, rt)); break;
+                case Op::Jal:
+                    r[RA] = pc_;
+                    pc_ = ins.target;
+                    break;
+                case Op::Jalr:
+                    r[RA] = pc_;
+                    pc_ = rs;
+                    break;
+                case Op::Jr: pc_ = rs; break;
+            }
+            r[0] = 0;
+        }
+    };
+
+    r[4] = Copy(Label("Main_protObj"));
+    call(Label("Main_init"));
+    call(Label("Main.main"));
+    if (!stopped_) {
+        output_ += "COOL program successfully executed\n";
+    }
+    return output_;
+}
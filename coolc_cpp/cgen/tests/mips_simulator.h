@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Runs the assembly cgen writes, for the tests: spim of the course is a
+// 32-bit binary that needs its own loader and trap.handler, neither of
+// which is at hand. The subset of MIPS assembly both cgens emit is
+// interpreted directly and the routines of trap.handler (Object.copy,
+// IO.out_string, equality_test, ...) are done natively, following the
+// conventions of the runtime: the object in $a0, arguments on the stack
+// and popped by the callee, $s registers preserved, $t0-$t4, $v0, $v1 and
+// $a1-$a3 trashed.
+//
+// Executed instructions of the program are counted as spim assembles them:
+// a la is a lui and an ori, a blt a slt and a bne, and so on. The runtime
+// routines are not counted.
+class MipsSimulator {
+   public:
+    // false, with the reason in `error`, if the assembly doesn't load
+    bool Load(std::string_view assembly, std::string& error);
+
+    // Runs Main.main as trap.handler does, with `input` on the standard
+    // input; what the program printed, then what the runtime printed when
+    // it stopped. Stops with an error after `limit` instructions.
+    std::string Run(std::string_view input, uint64_t limit = 1000000000);
+
+    uint64_t Instructions() const { return instructions_; }
+
+   private:
+    enum class Op {
+        Add, Addu, Sub, Subu, Mul, Div, Addiu, Sll, Move, Neg, Li, La, Lw, Sw,
+        B, Beqz, Bnez, Beq, Bne, Blt, Ble, Bgt, Bge, Jal, Jalr, Jr,
+    };
+
+    struct Instruction {
+        Op op;
+        uint8_t rd = 0;
+        uint8_t rs = 0;
+        uint8_t rt = 0;
+        // rt is an immediate, in imm
+        bool immediate = false;
+        int32_t imm = 0;
+        // the address of a label operand
+        uint32_t target = 0;
+        // what spim assembles it into
+        uint8_t weight = 1;
+        std::size_t line = 0;
+    };
+
+    // a label operand, resolved once everything is loaded
+    struct Fixup {
+        std::string label;
+        // the word of data at this address, or the target of an instruction
+        uint32_t address;
+        bool inText;
+        std::size_t line;
+    };
+
+    bool ParseInstruction(const std::vector<std::string_view>& tokens, std::size_t line, std::string& error);
+    bool ParseData(const std::vector<std::string_view>& tokens, std::string_view text, std::size_t line,
+                   std::string& error);
+
+    uint32_t Word(uint32_t address);
+    void SetWord(uint32_t address, uint32_t value);
+    uint32_t Allocate(uint32_t bytes);
+    uint32_t Label(const std::string& name) const { return labels_.at(name); }
+
+    // the runtime
+    bool Routine(uint32_t address);
+    uint32_t Copy(uint32_t object);
+    uint32_t NewInt(int32_t value);
+    uint32_t NewString(std::string_view text);
+    std::string String(uint32_t object);
+    std::string ClassName(uint32_t object);
+    std::string ReadLine();
+    void Stop(std::string message);
+
+   private:
+    std::vector<Instruction> text_;
+    std::vector<uint8_t> data_;
+    std::vector<uint8_t> stack_;
+    std::unordered_map<std::string, uint32_t> labels_;
+    std::vector<Fixup> fixups_;
+
+    std::array<uint32_t, 32> registers_{};
+    uint32_t pc_ = 0;
+    bool stopped_ = false;
+    std::string output_;
+    std::string_view input_;
+    uint64_t instructions_ = 0;
+};
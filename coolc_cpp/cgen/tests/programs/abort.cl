@@ -0,0 +1,9 @@
+class Main inherits IO {
+    main() : Object {
+        {
+            out_string("aborting\n");
+            abort();
+            out_string("not reached\n");
+        }
+    };
+};
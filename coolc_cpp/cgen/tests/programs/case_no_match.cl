@@ -0,0 +1,11 @@
+class A {};
+class B inherits A {};
+
+class Main inherits IO {
+    main() : Object {
+        case new A of
+            b : B => out_string("B\n");
+            m : Main => out_string("Main\n");
+        esac
+    };
+};
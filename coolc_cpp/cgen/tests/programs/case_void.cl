@@ -0,0 +1,7 @@
+class Main inherits IO {
+    main() : Object {
+        case let o : Object in o of
+            o : Object => out_string("matched\n");
+        esac
+    };
+};
@@ -0,0 +1,11 @@
+class Main inherits IO {
+    other : Main;
+
+    main() : Object {
+        {
+            out_string("before\n");
+            other.main();
+            out_string("after\n");
+        }
+    };
+};
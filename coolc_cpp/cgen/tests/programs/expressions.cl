@@ -0,0 +1,40 @@
+-- arithmetic, comparisons, equality, loops and the unary operators
+class Main inherits IO {
+    i : Int <- 10;
+    flag : Bool;
+    text : String;
+    nothing : Object;
+
+    print_bool(b : Bool) : Object {
+        if b then out_string("true ") else out_string("false ") fi
+    };
+
+    main() : Object {
+        {
+            out_int(i + 2 * 3 - 8 / 3);
+            out_string("\n");
+            out_int(~i);
+            out_string("\n");
+            print_bool(i < 10);
+            print_bool(i <= 10);
+            print_bool(not flag);
+            print_bool(isvoid nothing);
+            print_bool(isvoid self);
+            print_bool(i = 10);
+            print_bool(text = "");
+            print_bool("a" = "a".concat(""));
+            print_bool(self = self);
+            print_bool(self = new Main);
+            out_string("\n");
+            while 0 < i loop
+                {
+                    out_int(i);
+                    i <- i - 3;
+                }
+            pool;
+            out_string("\n");
+            out_int(1 / 3 - 7 / ~2);
+            out_string("\n");
+        }
+    };
+};
@@ -0,0 +1,43 @@
+-- more temporaries and bindings alive at once than there are registers,
+-- across calls and not, so some are spilled
+class Main inherits IO {
+    base : Int <- 1;
+
+    id(x : Int) : Int { x };
+
+    sum() : Int {
+        1 + (2 + (3 + (4 + (5 + (6 + (7 + (8 + (9 + (10 + (11 + (12 + (13 + (14 + base)))))))))))))
+    };
+
+    sum_calls() : Int {
+        id(1) + (id(2) + (id(3) + (id(4) + (id(5) + (id(6) + (id(7) + (id(8) + (id(9) + id(10)))))))))
+    };
+
+    lets() : Int {
+        let a : Int <- 1, b : Int <- a + 1, c : Int <- b + 1, d : Int <- c + 1, e : Int <- d + 1,
+            f : Int <- e + 1, g : Int <- f + 1, h : Int <- g + 1, i : Int <- id(h + 1), j : Int <- i + 1 in
+            a * (b - (c * (d - (e * (f - (g * (h - (i * (j - id(base))))))))))
+    };
+
+    main() : Object {
+        {
+            out_int(sum());
+            out_string(" ");
+            out_int(sum_calls());
+            out_string(" ");
+            out_int(lets());
+            out_string(" ");
+            let n : Int <- 0, total : Int <- 0 in
+                {
+                    while n < 10 loop
+                        {
+                            total <- total + n * (n - base) / 2;
+                            n <- n + 1;
+                        }
+                    pool;
+                    out_int(total);
+                };
+            out_string("\n");
+        }
+    };
+};
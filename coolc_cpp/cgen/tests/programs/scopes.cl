@@ -0,0 +1,55 @@
+-- lets, cases, formals and attributes with the same names, shadowing
+-- one another
+class Counter {
+    count : Int <- let one : Int <- 1 in one + one;
+    step : Int <- 3;
+
+    next(step : Int) : Int {
+        count <- count + step
+    };
+    count() : Int { count };
+    copy_me() : SELF_TYPE { new SELF_TYPE };
+};
+
+class Doubler inherits Counter {
+    next(step : Int) : Int {
+        self@Counter.next(step * 2)
+    };
+};
+
+class Main inherits IO {
+    step : Int <- 100;
+
+    name(o : Object) : String {
+        case o of
+            c : Doubler => "Doubler";
+            c : Counter => "Counter";
+            i : Int => "Int";
+            s : String => s;
+            o : Object => o.type_name();
+        esac
+    };
+
+    main() : Object {
+        let c : Counter <- new Doubler, step : Int <- 5 in
+            {
+                out_int(c.next(step));
+                out_string(" ");
+                let step : Int <- step + 1, step : Int <- step * 2 in
+                    out_int(c.next(step));
+                out_string(" ");
+                out_int(step);
+                out_string(" ");
+                out_int(self.step());
+                out_string("\n");
+                out_string(name(c).concat(" ").concat(name(c.copy_me())).concat(" "));
+                out_string(name(new Counter).concat(" ").concat(name(3)).concat(" "));
+                out_string(name("str").concat(" ").concat(name(true)).concat(" "));
+                out_string(name(self).concat("\n"));
+                out_int(c.copy_me().count());
+                out_string("\n");
+            }
+    };
+
+    step() : Int { step };
+};
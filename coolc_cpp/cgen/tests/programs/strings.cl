@@ -0,0 +1,17 @@
+-- the string methods of the runtime, escapes and reading lines
+class Main inherits IO {
+    main() : Object {
+        let line : String <- in_string(), number : Int <- in_int() in
+            {
+                out_string("tab\there, quote \" backslash \\ vertical \v form \f\n");
+                out_string(line.concat("|").concat(line.substr(1, 3)).concat("|"));
+                out_int(line.length());
+                out_string("\n");
+                out_int(number * 2);
+                out_string("\n");
+                out_string(in_string().concat("\n"));
+                out_string(type_name().concat(" ").concat(number.type_name()).concat("\n"));
+                out_string(line.substr(2, 100));
+            }
+    };
+};
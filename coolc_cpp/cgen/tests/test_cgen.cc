@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "cgen/code_generator.h"
+#include "mips_simulator.h"
+
+std::string exec(const std::string& cmd) {
+    std::array<char, 128> buffer;
+    std::string result;
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe) {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+        result += buffer.data();
+    }
+    return result;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+struct Run {
+    std::string output;
+    uint64_t instructions = 0;
+};
+
+Run run(const std::string& assembly, const std::string& input) {
+    MipsSimulator simulator;
+    std::string error;
+    EXPECT_TRUE(simulator.Load(assembly, error)) << error;
+    Run result;
+    result.output = simulator.Run(input);
+    result.instructions = simulator.Instructions();
+    return result;
+}
+
+std::string implode(const std::vector<std::string>& files) {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(), std::ostream_iterator<std::string>(imploded, " "));
+    return imploded.str();
+}
+
+// the assembly `cgen` writes for the typed AST of the reference semant
+std::string compile(const std::vector<std::string>& files, const std::string& cgen) {
+    return exec("../../resource/bin/lexer " + implode(files) +
+                " | ../../resource/bin/parser | ../../resource/bin/semant 2>/dev/null | " + cgen + " 2>/dev/null");
+}
+
+// The program compiled by our cgen does what the one compiled by the
+// reference cgen does, on the same input.
+void compare_programs(const std::vector<std::string>& files, const std::string& input = "") {
+    const std::string reference = compile(files, "../../resource/bin/cgen");
+    if (reference.empty()) {
+        // not a whole program (atoi.cl has no Main)
+        return;
+    }
+    const std::string assembly = compile(files, "./cgen");
+    ASSERT_FALSE(assembly.empty()) << implode(files);
+
+    const Run expected = run(reference, input);
+    const Run actual = run(assembly, input);
+    ASSERT_EQ(expected.output, actual.output) << implode(files);
+}
+
+// Temporaries and bindings in registers take fewer instructions than all of
+// them in memory, as with -s, for the same output.
+void compare_allocation(const std::string& name) {
+    const std::string file = "../../../examples/" + name + ".cl";
+    const std::string input = read_file("../../cgen/tests/inputs/" + name + ".in");
+    const Run stack = run(compile({file}, "./cgen -s"), input);
+    const Run registers = run(compile({file}, "./cgen"), input);
+    ASSERT_EQ(stack.output, registers.output) << file;
+    EXPECT_LT(registers.instructions, stack.instructions) << file;
+}
+
+TEST(Emitter, Ascii) {
+    std::FILE* file = std::tmpfile();
+    {
+        OutputBuffer out(file);
+        Emitter emitter(out);
+        emitter.Ascii("say \"hi\"\\\n\t");
+        emitter.Op("lw", "$a0", Mem{12, "$s0"});
+        emitter.Word(NumberedLabel{"int_const", 3});
+    }
+    std::rewind(file);
+    std::string text(256, '\0');
+    text.resize(std::fread(text.data(), 1, text.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(text,
+              "\t.ascii\t\"say \\\"hi\\\"\\\\\"\n"
+              "\t.byte\t10\n"
+              "\t.byte\t9\n"
+              "\tlw\t$a0 12($s0)\n"
+              "\t.word\tint_const3\n");
+}
+
+TEST(CodeGenerator, Unescape) {
+    EXPECT_EQ(CodeGenerator::Unescape("a\\nb\\tc"), "a\nb\tc");
+    EXPECT_EQ(CodeGenerator::Unescape("\\\"\\\\"), "\"\\");
+    EXPECT_EQ(CodeGenerator::Unescape("\\013\\033x"), "\013\033x");
+}
+
+TEST(CodeGenerator, Programs) {
+    for (const auto& entry : std::filesystem::directory_iterator("../../cgen/tests/programs")) {
+        if (entry.path().extension() == ".cl") {
+            std::filesystem::path input = entry.path();
+            compare_programs({entry.path()}, read_file(input.replace_extension(".in")));
+        }
+    }
+}
+
+TEST(CodeGenerator, Examples) {
+    for (const auto& entry : std::filesystem::directory_iterator("../../../examples")) {
+        if (entry.path().extension() == ".cl") {
+            const std::string input = "../../cgen/tests/inputs/" + entry.path().stem().string() + ".in";
+            compare_programs({entry.path()}, read_file(input));
+        }
+    }
+}
+
+TEST(CodeGenerator, StackMachine) {
+    compare_programs({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"},
+                     read_file("../../stack_example/stack.test"));
+}
+
+TEST(CodeGenerator, RegisterAllocation) {
+    for (const auto& name : {"arith", "life", "primes"}) {
+        compare_allocation(name);
+    }
+}
@@ -0,0 +1,268 @@
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cgen/code_generator.h"
+#include "lexer/parallel.h"
+#include "lexer/token.h"
+#include "lexer/token_source.h"
+#include "parser/parse_cache.h"
+#include "parser/parser.h"
+#include "parser/syntax.h"
+#include "semant/inheritance.h"
+#include "semant/type_checker.h"
+
+// Single-process compiler: tokens and the AST are handed from stage to stage
+// in memory. --lex, --parse and --semant additionally dump them in the format
+// of the standalone lexer, parser and semant, for debugging and comparison with
+// the reference. -o writes the assembly of the program to a file.
+struct Options {
+    bool dumpTokens = false;
+    bool dumpAst = false;
+    bool dumpTypedAst = false;
+    std::size_t jobs = 1;
+    // parsed classes are kept there between runs when set
+    std::string cacheDirectory;
+    // SPIM assembly goes there when set
+    std::string outputFile;
+    std::vector<std::string> filenames;
+};
+
+// Lexing runs in its own thread, a bounded ring ahead of the parser.
+const std::size_t TOKEN_RING_CAPACITY = 16 * TokenCursor::TOKEN_BATCH_SIZE;
+
+void usage() {
+    std::cerr << "Usage: ./coolc [--lex] [--parse] [--semant] [-j N] [--cache DIR] [-o FILE] [files ..]" << std::endl;
+}
+
+// All files go through one token stream, lexed in a thread of its own. The
+// stream ends early at a file that cannot be opened, so syntax errors are
+// only printed when every file was read.
+Program ParseSerial(const Options& options, std::string& failedFile, std::size_t& syntaxErrors) {
+    LexerTokenSource lexerSource(options.filenames);
+    Program program;
+    std::ostringstream errors;
+    if (options.dumpTokens) {
+        // lex everything up front, so the dump is complete even if parsing fails
+        std::vector<Token> tokens;
+        Token token;
+        while (lexerSource.Read(&token, 1) != 0) {
+            std::cout << token << '\n';
+            tokens.push_back(token);
+        }
+        std::cout.flush();
+        VectorTokenSource source(tokens);
+        Parser parser(source, errors);
+        program = parser.parseProgram();
+        syntaxErrors = parser.errorCount();
+    } else {
+        TokenRing ring(TOKEN_RING_CAPACITY);
+        std::thread lexerThread([&] { ring.Pump(lexerSource, TokenCursor::TOKEN_BATCH_SIZE); });
+        Parser parser(ring, errors);
+        program = parser.parseProgram();
+        syntaxErrors = parser.errorCount();
+
+        // let the lexer finish even if the parser stopped early
+        for (Token rest; ring.Read(&rest, 1) != 0;) {
+        }
+        lexerThread.join();
+    }
+    failedFile = lexerSource.FailedFile();
+    if (failedFile.empty()) {
+        std::cerr << errors.str();
+    }
+    return program;
+}
+
+// Tokens of every file, lexed on the pool, in argv order.
+std::vector<std::vector<Token>> LexParallel(const Options& options, std::vector<std::string>& failed) {
+    const std::size_t count = options.filenames.size();
+    std::vector<std::vector<Token>> tokens(count);
+    failed.resize(count);
+    ParallelFor(count, options.jobs, [&](std::size_t i) {
+        LexerTokenSource source({options.filenames[i]});
+        Token token;
+        while (source.Read(&token, 1) != 0) {
+            tokens[i].push_back(token);
+        }
+        failed[i] = source.FailedFile();
+    });
+    if (options.dumpTokens) {
+        for (const auto& fileTokens : tokens) {
+            for (const auto& token : fileTokens) {
+                std::cout << token << '\n';
+            }
+        }
+        std::cout.flush();
+    }
+    return tokens;
+}
+
+// Files are independent until semantic analysis: each one is lexed and
+// parsed into a Program of its own on the pool, then the classes are merged
+// in argv order, so the output is the same as the serial one. Syntax errors
+// are collected per file and printed in the same order. A file may have no
+// class; only a program without any is an error, reported once at the end.
+Program ParseParallel(const Options& options, std::string& failedFile, std::size_t& syntaxErrors) {
+    const std::size_t count = options.filenames.size();
+    std::vector<Program> programs(count);
+    std::vector<std::string> failed(count);
+    std::vector<std::ostringstream> errors(count);
+    std::vector<std::size_t> errorCounts(count);
+
+    if (options.dumpTokens) {
+        std::vector<std::vector<Token>> tokens = LexParallel(options, failed);
+        ParallelFor(count, options.jobs, [&](std::size_t i) {
+            VectorTokenSource source(tokens[i]);
+            Parser parser(source, errors[i]);
+            programs[i] = parser.parseFile();
+            errorCounts[i] = parser.errorCount();
+        });
+    } else {
+        ParallelFor(count, options.jobs, [&](std::size_t i) {
+            LexerTokenSource source({options.filenames[i]});
+            Parser parser(source, errors[i]);
+            programs[i] = parser.parseFile();
+            errorCounts[i] = parser.errorCount();
+            failed[i] = source.FailedFile();
+        });
+    }
+
+    Program program;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!failed[i].empty()) {
+            failedFile = failed[i];
+            break;
+        }
+        std::cerr << errors[i].str();
+        syntaxErrors += errorCounts[i];
+        program.classes.insert(program.classes.end(), programs[i].classes.begin(), programs[i].classes.end());
+        program.arena.Merge(std::move(programs[i].arena));
+    }
+    if (failedFile.empty() && syntaxErrors == 0 && program.classes.empty()) {
+        // where the serial parse stops: at the end of the last file
+        const std::vector<Token> tokens = {Token{TokenType::PROGRAM, options.filenames.back(), 0}};
+        VectorTokenSource source(tokens);
+        Parser parser(source);
+        program = parser.parseProgram();
+        syntaxErrors = parser.errorCount();
+    }
+    return program;
+}
+
+// Only the classes whose tokens changed since the last run are parsed, see
+// ParseCache. Input with syntax errors is parsed as a whole, for the errors.
+Program ParseCached(const Options& options, std::string& failedFile, std::size_t& syntaxErrors) {
+    std::vector<std::string> failed;
+    std::vector<std::vector<Token>> fileTokens = LexParallel(options, failed);
+    std::vector<Token> tokens;
+    for (std::size_t i = 0; i < fileTokens.size(); ++i) {
+        if (!failed[i].empty()) {
+            failedFile = failed[i];
+            return Program();
+        }
+        tokens.insert(tokens.end(), fileTokens[i].begin(), fileTokens[i].end());
+    }
+
+    Program program;
+    ParseCache cache(options.cacheDirectory);
+    if (!cache.Parse(tokens, options.jobs, program)) {
+        VectorTokenSource source(tokens);
+        Parser parser(source);
+        program = parser.parseProgram();
+        syntaxErrors = parser.errorCount();
+    }
+    return program;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--lex") {
+            options.dumpTokens = true;
+        } else if (arg == "--parse") {
+            options.dumpAst = true;
+        } else if (arg == "--semant") {
+            options.dumpTypedAst = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            if (!ParseJobs(argv[++i], options.jobs)) {
+                usage();
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cacheDirectory = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            options.outputFile = argv[++i];
+        } else if (arg.starts_with("-j") && arg.size() > 2) {
+            if (!ParseJobs(std::string_view(arg).substr(2), options.jobs)) {
+                usage();
+                return EXIT_FAILURE;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            usage();
+            return EXIT_FAILURE;
+        } else {
+            options.filenames.push_back(arg);
+        }
+    }
+    if (options.filenames.empty()) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::string failedFile;
+    std::size_t syntaxErrors = 0;
+    Program program;
+    if (!options.cacheDirectory.empty()) {
+        program = ParseCached(options, failedFile, syntaxErrors);
+    } else if (options.jobs > 1) {
+        program = ParseParallel(options, failedFile, syntaxErrors);
+    } else {
+        program = ParseSerial(options, failedFile, syntaxErrors);
+    }
+    if (!failedFile.empty()) {
+        std::cerr << "Could not open input file " << failedFile << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (syntaxErrors != 0) {
+        std::cerr << "Compilation halted due to lex and parse errors" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (options.dumpAst) {
+        PrintProgram(program);
+    }
+
+    InheritanceAnalyzer inherAnalyzer(program);
+    if (!inherAnalyzer.checkCorrectness()) {
+        std::cerr << "Compilation halted due to static semantic errors." << std::endl;
+        return EXIT_FAILURE;
+    }
+    TypeChecker typeChecker(inherAnalyzer, options.jobs);
+    if (!typeChecker.Check()) {
+        std::cerr << "Compilation halted due to static semantic errors." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (options.dumpTypedAst) {
+        PrintProgram(program);
+    }
+
+    if (!options.outputFile.empty()) {
+        std::FILE* file = std::fopen(options.outputFile.c_str(), "w");
+        if (!file) {
+            std::cerr << "Could not open output file " << options.outputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+        {
+            OutputBuffer out(file);
+            CodeGenerator(inherAnalyzer, typeChecker).Generate(out);
+        }
+        std::fclose(file);
+    }
+
+    return EXIT_SUCCESS;
+}
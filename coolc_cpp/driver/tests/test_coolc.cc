@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+std::string exec(const char* cmd) {
+    std::array<char, 128> buffer;
+    std::string result;
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd, "r"), pclose);
+    if (!pipe) {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+        result += buffer.data();
+    }
+    return result;
+}
+
+void compare_outputs(const std::string& reference_cmd, const std::string& cmd) {
+    std::string reference_output = exec(reference_cmd.c_str());
+    std::string output = exec(cmd.c_str());
+
+    std::istringstream ref(reference_output);
+    std::istringstream my(output);
+    while (!ref.eof() || !my.eof()) {
+        std::string ref_line, my_line;
+        getline(ref, ref_line);
+        getline(my, my_line);
+
+        // my and referece error handling not equal
+        if (ref_line.find("ERROR") != std::string::npos) {
+            return;
+        }
+
+        ASSERT_EQ(ref_line, my_line);
+    }
+}
+
+std::string implode(const std::vector<std::string>& files) {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(),
+              std::ostream_iterator<std::string>(imploded, " "));
+    return imploded.str();
+}
+
+void compare_tokens(const std::vector<std::string>& files) {
+    const std::string files_str = implode(files);
+    compare_outputs("../../resource/bin/lexer " + files_str,
+                    "./coolc --lex " + files_str + " 2>/dev/null");
+}
+
+void compare_ast(const std::vector<std::string>& files, const std::string& flags = "") {
+    const std::string files_str = implode(files);
+    const std::string reference_cmd = "../../resource/bin/lexer " + files_str + " | ../../resource/bin/parser";
+    if (exec(reference_cmd.c_str()).empty()) {
+        // syntax errors, see test_parser
+        return;
+    }
+    compare_outputs(reference_cmd, "./coolc --parse " + flags + " " + files_str + " 2>/dev/null");
+}
+
+// on syntax errors nothing but the errors is printed, as by the reference parser
+void compare_syntax_errors(const std::vector<std::string>& files, const std::string& flags = "") {
+    const std::string files_str = implode(files);
+    const std::string reference_cmd =
+        "../../resource/bin/lexer " + files_str + " | ../../resource/bin/parser 2>&1";
+    ASSERT_EQ(exec(reference_cmd.c_str()), exec(("./coolc --parse " + flags + " " + files_str + " 2>&1").c_str()));
+}
+
+TEST(EndToEnd, Tokens) {
+    const std::string path = "../../../examples";
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        compare_tokens({entry.path()});
+    }
+}
+
+TEST(EndToEnd, MultipleFileTokens) {
+    compare_tokens({"../../../examples/arith.cl", "../../../examples/atoi.cl"});
+}
+
+TEST(EndToEnd, Ast) {
+    const std::string path = "../../parser/tests/end-to-end";
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        compare_ast({entry.path()});
+    }
+}
+
+TEST(EndToEnd, MultipleFileAst) {
+    const std::string example_stack = "../../stack_example/stack.cl";
+    compare_ast({example_stack, "../../stack_example/atoi.cl"});
+}
+
+TEST(EndToEnd, ParallelMultipleFileAst) {
+    compare_ast({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"}, "-j 2");
+    compare_ast({"../../../examples/arith.cl", "../../../examples/atoi.cl",
+                 "../../../examples/io.cl", "../../../examples/hello_world.cl"}, "-j 4");
+}
+
+// a file without classes is fine as long as another one has some
+TEST(EndToEnd, ParallelClasslessFiles) {
+    const std::string comment = std::filesystem::temp_directory_path() / "coolc_comment.cl";
+    const std::string empty = std::filesystem::temp_directory_path() / "coolc_empty.cl";
+    std::ofstream(comment) << "-- only a comment\n";
+    std::ofstream{empty};
+    compare_ast({"../../../examples/hello_world.cl", comment, empty, "../../../examples/io.cl"}, "-j 4");
+    compare_syntax_errors({comment, empty}, "-j 2");
+    std::filesystem::remove(comment);
+    std::filesystem::remove(empty);
+}
+
+TEST(EndToEnd, TypedAst) {
+    const std::string files_str = implode({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"});
+    compare_outputs("../../resource/bin/lexer " + files_str + " | ../../resource/bin/parser | ../../resource/bin/semant",
+                    "./coolc --semant -j 2 " + files_str + " 2>/dev/null");
+}
+
+// the assembly written by -o is what cgen writes for the typed AST
+TEST(EndToEnd, Assembly) {
+    const std::string files_str = implode({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"});
+    const std::string output = std::filesystem::temp_directory_path() / "coolc_stack.s";
+    std::filesystem::remove(output);
+    exec(("./coolc -o " + output + " " + files_str).c_str());
+    compare_outputs("../../resource/bin/lexer " + files_str +
+                        " | ../../resource/bin/parser | ../../resource/bin/semant | ./cgen",
+                    "cat " + output);
+}
+
+TEST(EndToEnd, SyntaxErrors) {
+    const std::string path = "../../parser/tests/end-to-end";
+    for (const auto& name : {"badfeatures.test", "casenoexpr.test", "firstbindingerrored.test",
+                             "ifnoelse.test", "multiplemethoderrors.test", "emptyprogram.test"}) {
+        compare_syntax_errors({path + "/" + name});
+    }
+    compare_syntax_errors({path + "/badblock.test", path + "/while.test"}, "-j 2");
+}
+
+TEST(EndToEnd, ParseCache) {
+    const std::filesystem::path cache = std::filesystem::temp_directory_path() / "coolc_parse_cache";
+    const std::string path = std::filesystem::temp_directory_path() / "parse_cache.cl";
+    std::filesystem::remove_all(cache);
+    const auto entries = [&] {
+        return std::distance(std::filesystem::directory_iterator(cache), std::filesystem::directory_iterator());
+    };
+    const auto write = [&](const std::string& top, const std::string& body) {
+        std::ofstream out(path);
+        out << top << "class Main { main() : Object { new A.f(1) }; };\n";
+        out << "class A {\n  f(x : Int) : Int { " << body << " };\n};\n";
+        out << "class B inherits A {\n  g : Int <- 3;\n};\n";
+    };
+    const std::string flags = "--cache " + cache.string();
+
+    write("", "x + 1");
+    compare_ast({path}, flags);
+    ASSERT_EQ(entries(), 3);
+    compare_ast({path}, flags);
+    ASSERT_EQ(entries(), 3);
+
+    // one class changed, all moved down: only the changed one is parsed again
+    write("\n\n", "x * 2");
+    compare_ast({path}, flags);
+    ASSERT_EQ(entries(), 4);
+
+    compare_ast({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"}, flags + " -j 2");
+    compare_syntax_errors({"../../parser/tests/end-to-end/badfeatures.test"}, flags);
+
+    std::filesystem::remove_all(cache);
+    std::filesystem::remove(path);
+}
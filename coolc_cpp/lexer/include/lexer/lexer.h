@@ -1,14 +1,16 @@
 #pragma once
 
-#include <set>
+#include <string_view>
+#include <vector>
 
 #include "lexer/token.h"
+#include "lexer/source_file.h"
 
 class Lexer {
    public:
     Lexer() : lineOfCode(1), curr_idx(0), isEof(false) {}
 
-    void ReadFile(const std::string& filename);
+    bool ReadFile(const std::string& filename);
 
     Token ParseInteger();
     Token ParseString();
@@ -21,20 +23,13 @@ class Lexer {
     Token NextToken();
 
     void PrintResult();
-
-   private:
-    bool isSpaceSymbol(char ch) const {
-        const std::set<char> spaceSymbols{'\f', '\r', '\t', '\v', ' '};
-        return spaceSymbols.count(ch);
-    }
-
-    bool isNewLineSymbol(char ch) const {
-        return ch == '\n';
-    }
+    // same tokens as PrintResult, for the binary token stream
+    void CollectResult(std::vector<Token>& tokens);
 
    private:
     std::string filename;
-    std::string source_code;
+    SourceFile source_file;
+    std::string_view source_code;
     std::size_t lineOfCode;
     std::size_t curr_idx;
     bool isEof;
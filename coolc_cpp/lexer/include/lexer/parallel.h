@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+// Runs task(0) .. task(count - 1) on up to `jobs` threads and returns once
+// all of them are done. Indices are handed out in increasing order, so the
+// first files of a command line are picked up first. With one job, or one
+// task, everything runs on the calling thread.
+void ParallelFor(std::size_t count, std::size_t jobs, const std::function<void(std::size_t)>& task);
+
+// Parses the argument of -j. 0 stands for the number of hardware threads;
+// returns false if `arg` isn't a number.
+bool ParseJobs(std::string_view arg, std::size_t& jobs);
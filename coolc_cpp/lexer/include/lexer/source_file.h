@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only source buffer. Regular files are mmap'ed, so the lexer works
+// straight on the page cache without copying. Anything that can't be mapped
+// (pipes, character devices) is read in page-aligned chunks instead.
+class SourceFile {
+   public:
+    SourceFile() = default;
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    std::string_view View() const {
+        if (mapping_ != nullptr) {
+            return {static_cast<const char*>(mapping_), size_};
+        }
+        return buffer_;
+    }
+
+   private:
+    bool ReadChunked(int fd);
+
+   private:
+    void* mapping_ = nullptr;
+    std::size_t size_ = 0;
+    std::string buffer_;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Global intern table for identifiers, type names and constants (the
+// idtable/inttable/stringtable of the cool-tour handout rolled into one).
+// Every distinct string is stored once; entries never move or die, so a
+// Symbol can hold a plain pointer to its entry.
+class SymbolTable {
+   public:
+    struct Entry {
+        std::string text;
+        uint32_t id;
+    };
+
+    static SymbolTable& Global();
+
+    const Entry* Intern(std::string_view text);
+    // entry with the given id, nullptr if there is none
+    const Entry* Find(uint32_t id) const;
+    std::size_t Size() const;
+
+   private:
+    SymbolTable() = default;
+
+    // Intern behind the lock, for strings the calling thread hasn't seen
+    const Entry* InternShared(std::string_view text);
+
+   private:
+    mutable std::mutex mutex_;
+    std::deque<Entry> entries_;
+    std::unordered_map<std::string_view, const Entry*> index_;
+};
+
+class Symbol {
+   public:
+    // the empty symbol, copied from Empty() without going to the table
+    Symbol() : entry_(Empty().entry_) {}
+    Symbol(std::string_view text) : entry_(SymbolTable::Global().Intern(text)) {}
+    Symbol(const char* text) : Symbol(std::string_view(text)) {}
+    Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+
+    const std::string& str() const { return entry_->text; }
+    std::string_view view() const { return entry_->text; }
+    uint32_t id() const { return entry_->id; }
+    bool empty() const { return entry_->text.empty(); }
+
+    // Symbols every token and node starts out with, interned on first use
+    // only: their copies take no lock.
+    static const Symbol& Empty() {
+        static const Symbol empty(std::string_view{});
+        return empty;
+    }
+    static const Symbol& NoType() {
+        static const Symbol noType("_no_type");
+        return noType;
+    }
+
+    friend bool operator==(const Symbol& lhs, const Symbol& rhs) { return lhs.entry_ == rhs.entry_; }
+    // compares the text without interning the literal
+    friend bool operator==(const Symbol& lhs, const char* rhs) { return lhs.entry_->text == rhs; }
+
+    friend std::ostream& operator<<(std::ostream& out, const Symbol& symbol) {
+        return out << symbol.entry_->text;
+    }
+
+    friend std::istream& operator>>(std::istream& in, Symbol& symbol) {
+        std::string text;
+        if (in >> text) {
+            symbol = Symbol(text);
+        }
+        return in;
+    }
+
+   private:
+    const SymbolTable::Entry* entry_;
+};
+
+template <>
+struct std::hash<Symbol> {
+    std::size_t operator()(const Symbol& symbol) const noexcept { return symbol.id(); }
+};
@@ -5,6 +5,12 @@
 #include <set>
 #include <string>
 #include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+#include "lexer/symbol.h"
 
 enum class TokenType {
     CLASS,
@@ -38,59 +44,48 @@ enum class TokenType {
     EOFILE
 };
 
-inline std::map<TokenType, std::string> TokenTypeName = {
-    {TokenType::CLASS, "CLASS"},
-    {TokenType::ELSE, "ELSE"},
-    {TokenType::FI, "FI"},
-    {TokenType::IF, "IF"},
-    {TokenType::IN, "IN"},
-    {TokenType::INHERITS, "INHERITS"},
-    {TokenType::ISVOID, "ISVOID"},
-    {TokenType::LET, "LET"},
-    {TokenType::LOOP, "LOOP"},
-    {TokenType::POOL, "POOL"},
-    {TokenType::THEN, "THEN"},
-    {TokenType::WHILE, "WHILE"},
-    {TokenType::CASE, "CASE"},
-    {TokenType::ESAC, "ESAC"},
-    {TokenType::DARROW, "DARROW"},
-    {TokenType::NEW, "NEW"},
-    {TokenType::OF, "OF"},
-    {TokenType::NOT, "NOT"},
-    {TokenType::STR_CONST, "STR_CONST"},
-    {TokenType::INT_CONST, "INT_CONST"},
-    {TokenType::BOOL_CONST, "BOOL_CONST"},
-    {TokenType::TYPEID, "TYPEID"},
-    {TokenType::OBJECTID, "OBJECTID"},
-    {TokenType::ERROR, "ERROR"},
-    {TokenType::LE, "LE"},
-    {TokenType::ASSIGN, "ASSIGN"},
-    {TokenType::PUNCTUATION, ""},
+// names of the token types as the lexer prints them, indexed by TokenType;
+// PUNCTUATION, PROGRAM and EOFILE aren't printed by name
+inline constexpr std::string_view TokenTypeNames[] = {
+    "CLASS",
+    "ELSE",
+    "FI",
+    "IF",
+    "IN",
+    "INHERITS",
+    "ISVOID",
+    "LET",
+    "LOOP",
+    "POOL",
+    "THEN",
+    "WHILE",
+    "CASE",
+    "ESAC",
+    "DARROW",
+    "NEW",
+    "OF",
+    "NOT",
+    "STR_CONST",
+    "INT_CONST",
+    "BOOL_CONST",
+    "TYPEID",
+    "OBJECTID",
+    "ERROR",
+    "LE",
+    "ASSIGN",
+    "",  // PUNCTUATION
+    "",  // PROGRAM
+    "",  // EOFILE
 };
+static_assert(std::size(TokenTypeNames) == static_cast<std::size_t>(TokenType::EOFILE) + 1);
 
-inline std::map<std::string, TokenType> keywords = {
-    {"class", TokenType::CLASS},
-    {"else", TokenType::ELSE},
-    {"fi", TokenType::FI},
-    {"if", TokenType::IF},
-    {"in", TokenType::IN},
-    {"inherits", TokenType::INHERITS},
-    {"isvoid", TokenType::ISVOID},
-    {"let", TokenType::LET},
-    {"loop", TokenType::LOOP},
-    {"pool", TokenType::POOL},
-    {"then", TokenType::THEN},
-    {"while", TokenType::WHILE},
-    {"case", TokenType::CASE},
-    {"esac", TokenType::ESAC},
-    {"new", TokenType::NEW},
-    {"of", TokenType::OF},
-    {"not", TokenType::NOT},
-};
+constexpr std::string_view TokenTypeName(TokenType type) {
+    return TokenTypeNames[static_cast<std::size_t>(type)];
+}
 
 struct Token {
     TokenType tokenType;
-    std::string rawValue;
+    Symbol rawValue;
     std::size_t lineOfCode;
 
     friend inline std::ostream &operator<<(std::ostream &out, const Token &token);
@@ -106,9 +101,12 @@ inline std::istream &operator>>(std::istream &in, Token &token) {
     if (sharpPart[0] != '#') {
         assert(false);
     }
-    sharpPart = sharpPart.substr(1, sharpPart.size() - 1);
-     
-    if (sharpPart.find_first_not_of("0123456789") != std::string::npos) {
+    const char* lineBegin = sharpPart.data() + 1;
+    const char* lineEnd = sharpPart.data() + sharpPart.size();
+    std::size_t lineOfCode = 0;
+    auto [parsedEnd, ec] = std::from_chars(lineBegin, lineEnd, lineOfCode);
+
+    if (ec != std::errc() || parsedEnd != lineEnd) {
         std::string filename;
         in >> filename;
         filename = filename.substr(1, filename.size() - 2);
@@ -116,24 +114,30 @@ inline std::istream &operator>>(std::istream &in, Token &token) {
         token.rawValue = filename;
         return in;
     }
-    token.lineOfCode = std::stoi(sharpPart);
+    token.lineOfCode = lineOfCode;
 
     std::string tokenTypeOrLiteral;
     in >> tokenTypeOrLiteral;
     if (tokenTypeOrLiteral[0] == '\'') {
         token.tokenType = TokenType::PUNCTUATION;
-        token.rawValue = tokenTypeOrLiteral.substr(1, tokenTypeOrLiteral.size() - 2);
+        token.rawValue = std::string_view(tokenTypeOrLiteral).substr(1, tokenTypeOrLiteral.size() - 2);
         return in;
     }
 
-    std::map<std::string, TokenType> NameTokenType;
-    for (const auto& [k, v]: TokenTypeName) {
-        NameTokenType[v] = k;
-    }
-    
-    if (!NameTokenType.count(tokenTypeOrLiteral)) assert(false);
+    static const std::map<std::string_view, TokenType> NameTokenType = [] {
+        std::map<std::string_view, TokenType> nameTokenType;
+        for (std::size_t i = 0; i < std::size(TokenTypeNames); ++i) {
+            if (!TokenTypeNames[i].empty()) {
+                nameTokenType[TokenTypeNames[i]] = static_cast<TokenType>(i);
+            }
+        }
+        return nameTokenType;
+    }();
+
+    auto it = NameTokenType.find(tokenTypeOrLiteral);
+    if (it == NameTokenType.end()) assert(false);
 
-    token.tokenType = NameTokenType[tokenTypeOrLiteral];
+    token.tokenType = it->second;
 
     static const std::set<TokenType> print_raws_tokens = {
         TokenType::STR_CONST,
@@ -145,11 +149,18 @@ inline std::istream &operator>>(std::istream &in, Token &token) {
     };
 
     if (print_raws_tokens.count(token.tokenType)) {
-        std::getline(std::cin, token.rawValue);
-        auto start = token.rawValue.find_first_not_of(' ');
-        auto end = token.rawValue.find_last_not_of(' ');
-        std::string trimmedString;
-        token.rawValue = token.rawValue.substr(start, (end - start) + 1);
+        std::string rawValue;
+        std::getline(in, rawValue);
+        auto start = rawValue.find_first_not_of(' ');
+        auto end = rawValue.find_last_not_of(' ');
+        std::string_view trimmed = std::string_view(rawValue).substr(start, (end - start) + 1);
+        if (token.tokenType == TokenType::STR_CONST || token.tokenType == TokenType::ERROR) {
+            // printed quoted, see operator<<
+            trimmed = trimmed.substr(1, trimmed.size() - 2);
+        }
+        token.rawValue = trimmed;
+    } else {
+        token.rawValue = Symbol();
     }
 
     return in;
@@ -172,19 +183,19 @@ inline std::ostream &operator<<(std::ostream &out, const Token &token) {
         if (token.tokenType == TokenType::STR_CONST ||
             token.tokenType == TokenType::ERROR) {
             out << "#" << token.lineOfCode << " "
-                << TokenTypeName[token.tokenType] << " \"" << token.rawValue
+                << TokenTypeName(token.tokenType) << " \"" << token.rawValue
                 << "\"";
             ;
         } else {
             out << "#" << token.lineOfCode << " "
-                << TokenTypeName[token.tokenType] << " " << token.rawValue;
+                << TokenTypeName(token.tokenType) << " " << token.rawValue;
         }
     } else {
         if (token.tokenType == TokenType::PUNCTUATION) {
             out << "#" << token.lineOfCode << " '" << token.rawValue << "'";
         } else {
             out << "#" << token.lineOfCode << " "
-                << TokenTypeName[token.tokenType];
+                << TokenTypeName(token.tokenType);
         }
     }
 
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lexer/lexer.h"
+#include "lexer/token.h"
+
+// Pull interface the parser reads its tokens from.
+class TokenSource {
+   public:
+    virtual ~TokenSource() = default;
+
+    // Stores up to `capacity` next tokens into `out` and returns how many were
+    // stored. 0 means the stream is over, and every later call returns 0 too.
+    virtual std::size_t Read(Token* out, std::size_t capacity) = 0;
+};
+
+class VectorTokenSource : public TokenSource {
+   public:
+    explicit VectorTokenSource(const std::vector<Token>& tokens) : tokens_(tokens) {}
+
+    std::size_t Read(Token* out, std::size_t capacity) override;
+
+   private:
+    const std::vector<Token>& tokens_;
+    std::size_t pos_ = 0;
+};
+
+// Reads the textual `lexer` output.
+class StreamTokenSource : public TokenSource {
+   public:
+    explicit StreamTokenSource(std::istream& in) : in_(in) {}
+
+    std::size_t Read(Token* out, std::size_t capacity) override;
+
+   private:
+    std::istream& in_;
+};
+
+// Lexes the files one after another, producing the same tokens as
+// `lexer` prints: a PROGRAM token per file, then its tokens up to the end
+// or the first error.
+class LexerTokenSource : public TokenSource {
+   public:
+    explicit LexerTokenSource(std::vector<std::string> filenames) : filenames_(std::move(filenames)) {}
+
+    std::size_t Read(Token* out, std::size_t capacity) override;
+
+    // the file that couldn't be opened, empty if there was none
+    const std::string& FailedFile() const { return failedFile_; }
+
+   private:
+    std::vector<std::string> filenames_;
+    std::size_t fileIdx_ = 0;
+    std::unique_ptr<Lexer> lexer_;
+    std::string failedFile_;
+};
+
+// Bounded token queue between a lexer thread and the parser thread. Tokens
+// move in batches, so the lock is taken once per batch rather than per token.
+class TokenRing : public TokenSource {
+   public:
+    explicit TokenRing(std::size_t capacity) : ring_(capacity) {}
+
+    // blocks while the ring is full
+    void Write(const Token* tokens, std::size_t count);
+    // no more writes; readers drain what is left and then see the end
+    void Close();
+
+    // blocks while the ring is empty and not closed
+    std::size_t Read(Token* out, std::size_t capacity) override;
+
+    // moves every token of `source` into the ring and closes it
+    void Pump(TokenSource& source, std::size_t batchSize);
+
+   private:
+    std::vector<Token> ring_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    bool closed_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "lexer/token.h"
+
+// Binary wire format between `lexer -b` and the parser. The textual format
+// of operator<< stays the reference one; this one exists for speed.
+//
+// Layout (native byte order):
+//   TokenStreamHeader
+//   TokenRecord[header.tokenCount]
+//   char[header.poolSize]           string pool, every distinct value once
+struct TokenStreamHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tokenCount;
+    uint32_t poolSize;
+    uint32_t reserved;
+};
+
+struct TokenRecord {
+    uint32_t tokenType;
+    uint32_t lineOfCode;
+    uint32_t offset;  // of rawValue in the string pool
+    uint32_t length;
+};
+
+inline constexpr char TOKEN_STREAM_MAGIC[8] = {'C', 'O', 'O', 'L', 'T', 'O', 'K', '\0'};
+inline constexpr uint32_t TOKEN_STREAM_VERSION = 1;
+
+bool IsBinaryTokenStream(std::string_view data);
+
+void WriteTokenStream(std::FILE* out, const std::vector<Token>& tokens);
+// returns false if `data` isn't a well-formed token stream
+bool ReadTokenStream(std::string_view data, std::vector<Token>& tokens);
@@ -0,0 +1,413 @@
+#include "lexer/lexer.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "lexer/token.h"
+
+namespace {
+
+// Character classes of the COOL lexer, one table lookup per byte instead of
+// ctype calls and per-call std::set/std::map construction.
+enum CharClass : uint8_t {
+    kSpace = 1 << 0,        // blanks except newline
+    kDigit = 1 << 1,
+    kAlpha = 1 << 2,
+    kIdentifier = 1 << 3,   // letters, digits and '_'
+    kPunctuation = 1 << 4,  // single-character punctuation
+    kStringPlain = 1 << 5,  // copied into a string constant as is
+    kCommentDelimiter = 1 << 6,  // may open, close or count lines in a block comment
+};
+
+constexpr std::array<uint8_t, 256> MakeCharClasses() {
+    std::array<uint8_t, 256> table{};
+    for (char ch : {'\f', '\r', '\t', '\v', ' '}) {
+        table[static_cast<unsigned char>(ch)] |= kSpace;
+    }
+    for (int ch = '0'; ch <= '9'; ++ch) {
+        table[ch] |= kDigit | kIdentifier;
+    }
+    for (int ch = 'a'; ch <= 'z'; ++ch) {
+        table[ch] |= kAlpha | kIdentifier;
+        table[ch - 'a' + 'A'] |= kAlpha | kIdentifier;
+    }
+    table['_'] |= kIdentifier;
+    for (char ch : {'(', ')', '.', ',', ':', ';', '{', '}', '@', '~', '*', '/', '+', '-', '='}) {
+        table[static_cast<unsigned char>(ch)] |= kPunctuation;
+    }
+    for (char ch : {'(', '*', ')', '\n'}) {
+        table[static_cast<unsigned char>(ch)] |= kCommentDelimiter;
+    }
+    for (int ch = 0; ch < 256; ++ch) {
+        table[ch] |= kStringPlain;
+    }
+    for (char ch : {'\n', '\0', '"', '\\', '\t', '\f', '\b', char(013), char(015), char(022), char(033)}) {
+        table[static_cast<unsigned char>(ch)] &= ~kStringPlain;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> kCharClass = MakeCharClasses();
+
+// Control characters that are printed escaped inside string constants.
+constexpr std::array<const char*, 256> MakeStringEscapes() {
+    std::array<const char*, 256> table{};
+    table['\t'] = "\\t";
+    table['\f'] = "\\f";
+    table['\b'] = "\\b";
+    table[013] = "\\013";
+    table[015] = "\\015";
+    table[022] = "\\022";
+    table[033] = "\\033";
+    return table;
+}
+
+constexpr std::array<const char*, 256> kStringEscapes = MakeStringEscapes();
+
+inline bool HasClass(char ch, uint8_t cls) {
+    return kCharClass[static_cast<unsigned char>(ch)] & cls;
+}
+
+inline bool IsForceEscaped(char ch) {
+    return ch == 'b' || ch == 't' || ch == 'n' || ch == 'f' || ch == '"' || ch == '\\';
+}
+
+struct Keyword {
+    std::string_view name;
+    TokenType type;
+};
+
+constexpr Keyword kKeywords[] = {
+    {"class", TokenType::CLASS},
+    {"else", TokenType::ELSE},
+    {"fi", TokenType::FI},
+    {"if", TokenType::IF},
+    {"in", TokenType::IN},
+    {"inherits", TokenType::INHERITS},
+    {"isvoid", TokenType::ISVOID},
+    {"let", TokenType::LET},
+    {"loop", TokenType::LOOP},
+    {"pool", TokenType::POOL},
+    {"then", TokenType::THEN},
+    {"while", TokenType::WHILE},
+    {"case", TokenType::CASE},
+    {"esac", TokenType::ESAC},
+    {"new", TokenType::NEW},
+    {"of", TokenType::OF},
+    {"not", TokenType::NOT},
+};
+
+// keywords are case insensitive, `lower` is already lower case
+inline bool EqualsLower(std::string_view word, std::string_view lower) {
+    if (word.size() != lower.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        if ((word[i] | 0x20) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __SSE2__
+inline uint32_t MatchMask(__m128i chunk, char ch) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(ch)));
+}
+#endif
+
+// Returns the index of the first non-blank byte at or after `idx` and adds
+// the newlines passed over to `lines`.
+std::size_t SkipBlanks(std::string_view text, std::size_t idx, std::size_t& lines) {
+#ifdef __SSE2__
+    while (idx + 16 <= text.size()) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + idx));
+        const uint32_t newlines = MatchMask(chunk, '\n');
+        const uint32_t blanks = newlines | MatchMask(chunk, ' ') | MatchMask(chunk, '\t') |
+                                MatchMask(chunk, '\r') | MatchMask(chunk, '\f') | MatchMask(chunk, '\v');
+        if (blanks != 0xFFFF) {
+            const int skip = __builtin_ctz(~blanks);
+            lines += __builtin_popcount(newlines & ((1u << skip) - 1));
+            return idx + skip;
+        }
+        lines += __builtin_popcount(newlines);
+        idx += 16;
+    }
+#endif
+    for (; idx != text.size(); ++idx) {
+        if (text[idx] == '\n') {
+            ++lines;
+        } else if (!HasClass(text[idx], kSpace)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+// Returns the index of the first byte at or after `idx` that can change the
+// state of a block comment: '(', '*', ')' or a newline.
+std::size_t FindCommentDelimiter(std::string_view text, std::size_t idx) {
+#ifdef __SSE2__
+    while (idx + 16 <= text.size()) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + idx));
+        const uint32_t delimiters = MatchMask(chunk, '(') | MatchMask(chunk, '*') |
+                                    MatchMask(chunk, ')') | MatchMask(chunk, '\n');
+        if (delimiters != 0) {
+            return idx + __builtin_ctz(delimiters);
+        }
+        idx += 16;
+    }
+#endif
+    for (; idx != text.size(); ++idx) {
+        if (HasClass(text[idx], kCommentDelimiter)) {
+            break;
+        }
+    }
+    return idx;
+}
+
+}  // namespace
+
+bool Lexer::ReadFile(const std::string& filename) {
+    this->filename = filename;
+    if (!source_file.Open(filename)) {
+        return false;
+    }
+    source_code = source_file.View();
+    return true;
+}
+
+Token Lexer::ParseInteger() {
+    std::size_t begin_idx = curr_idx;
+    while (curr_idx + 1 != source_code.size() &&
+           HasClass(source_code[curr_idx + 1], kDigit)) {
+        ++curr_idx;
+    }
+    const auto size = curr_idx - begin_idx + 1;
+    const std::string_view rawInteger = source_code.substr(begin_idx, size);
+    ++curr_idx;
+    return Token{TokenType::INT_CONST, rawInteger, lineOfCode};
+}
+
+Token Lexer::ParseString() {
+    ++curr_idx;
+    std::string str;
+    while (true) {
+        std::size_t begin_idx = curr_idx;
+        while (curr_idx != source_code.size() &&
+               HasClass(source_code[curr_idx], kStringPlain)) {
+            ++curr_idx;
+        }
+        str.append(source_code.substr(begin_idx, curr_idx - begin_idx));
+
+        if (curr_idx == source_code.size()) {
+            return Token{TokenType::ERROR, "EOF in string constant", lineOfCode};
+        }
+        if (source_code[curr_idx] == '\n') {
+            ++lineOfCode;
+            curr_idx += 1;
+            return Token{TokenType::ERROR, "Unterminated string constant",
+                         lineOfCode};
+        }
+        if (source_code[curr_idx] == '\0') {
+            curr_idx += 1;
+            return Token{TokenType::ERROR, "String contains null character.",
+                         lineOfCode};
+        }
+        if (source_code[curr_idx] == '\"') {
+            ++curr_idx;
+            return Token{TokenType::STR_CONST, str, lineOfCode};
+        }
+
+        if (const char* escaped = kStringEscapes[static_cast<unsigned char>(source_code[curr_idx])]) {
+            str += escaped;
+            ++curr_idx;
+            continue;
+        }
+
+        // backslash
+        if (curr_idx + 1 == source_code.size()) {
+            ++curr_idx;
+            return Token{TokenType::ERROR, "EOF in string constant", lineOfCode};
+        }
+        ++curr_idx;
+        const char escaped_symbol = source_code[curr_idx];
+        if (IsForceEscaped(escaped_symbol)) {
+            str += '\\';
+            str += escaped_symbol;
+        } else if (const char* escaped = kStringEscapes[static_cast<unsigned char>(escaped_symbol)]) {
+            str += escaped;
+        } else if (escaped_symbol == '\n') {
+            ++lineOfCode;
+            str += "\\n";
+        } else if (escaped_symbol == '\0') {
+            return Token{TokenType::ERROR, "String contains escaped null character.",
+                         lineOfCode};
+        } else {
+            str += escaped_symbol;
+        }
+        ++curr_idx;
+    }
+
+    return Token{TokenType::ERROR, "String not parsed", lineOfCode};
+}
+
+Token Lexer::ParseIdentifier() {
+    // Type identifiers begin with a capital letter; object identifiers begin
+    // with a lower case letter.
+    std::size_t begin_idx = curr_idx;
+    while (curr_idx + 1 != source_code.size() &&
+           HasClass(source_code[curr_idx + 1], kIdentifier)) {
+        ++curr_idx;
+    }
+    const auto size = curr_idx - begin_idx + 1;
+    const std::string_view rawIdentifier = source_code.substr(begin_idx, size);
+    ++curr_idx;
+
+    if (size <= 8) {
+        for (const auto& keyword : kKeywords) {
+            if (EqualsLower(rawIdentifier, keyword.name)) {
+                return Token{keyword.type, rawIdentifier, lineOfCode};
+            }
+        }
+        const bool isLower = rawIdentifier[0] >= 'a' && rawIdentifier[0] <= 'z';
+        if (isLower && EqualsLower(rawIdentifier, "false")) {
+            return Token{TokenType::BOOL_CONST, "false", lineOfCode};
+        }
+        if (isLower && EqualsLower(rawIdentifier, "true")) {
+            return Token{TokenType::BOOL_CONST, "true", lineOfCode};
+        }
+    }
+
+    TokenType type = (rawIdentifier[0] >= 'a' && rawIdentifier[0] <= 'z') ? TokenType::OBJECTID
+                                                                          : TokenType::TYPEID;
+
+    return Token{type, rawIdentifier, lineOfCode};
+}
+
+Token Lexer::ParsePunctuation() {
+    if (source_code[curr_idx] == '<') {
+        ++curr_idx;
+        if (curr_idx == source_code.size()) {
+            return {TokenType::PUNCTUATION, "<", lineOfCode};
+        }
+        if (source_code[curr_idx] == '-') {
+            ++curr_idx;
+            return {TokenType::ASSIGN, "", lineOfCode};
+        }
+        if (source_code[curr_idx] == '=') {
+            ++curr_idx;
+            return {TokenType::LE, "", lineOfCode};
+        }
+
+        return {TokenType::PUNCTUATION, "<", lineOfCode};
+    }
+
+    if (curr_idx + 1 != source_code.size() && source_code[curr_idx] == '=' && source_code[curr_idx + 1] == '>') {
+        curr_idx += 2;
+        return {TokenType::DARROW, "=>", lineOfCode};
+    }
+
+    if (HasClass(source_code[curr_idx], kPunctuation)) {
+        return Token{TokenType::PUNCTUATION,
+                     source_code.substr(curr_idx++, 1), lineOfCode};
+    }
+
+    ++curr_idx;
+
+    return Token{TokenType::ERROR, "Punctuation not parsed", lineOfCode};
+}
+
+void Lexer::ParseLineComment() {
+    const void* eol = std::memchr(source_code.data() + curr_idx, '\n', source_code.size() - curr_idx);
+    if (eol == nullptr) {
+        curr_idx = source_code.size();
+        return;
+    }
+    curr_idx = static_cast<const char*>(eol) - source_code.data() + 1;
+    ++lineOfCode;
+}
+
+bool Lexer::ParseMultiLineComment() {
+    int cnt = 1;
+    ++curr_idx;
+    char prev_symbol = source_code[curr_idx - 1];
+    char cur_symbol = source_code[curr_idx];
+    while (curr_idx + 1 != source_code.size()) {
+        ++curr_idx;
+        prev_symbol = cur_symbol;
+        cur_symbol = source_code[curr_idx];
+        if (!HasClass(cur_symbol, kCommentDelimiter)) {
+            // nothing up to the next delimiter can change the nesting
+            curr_idx = FindCommentDelimiter(source_code, curr_idx) - 1;
+            cur_symbol = source_code[curr_idx];
+            continue;
+        }
+        if (cur_symbol == ')' && prev_symbol == '*' && source_code[curr_idx - 2] != '(') {
+            if (--cnt == 0) break;
+        }
+        if (cur_symbol == '*' && prev_symbol == '(') {
+            ++cnt;
+        }
+        if (cur_symbol == '\n') {
+            ++lineOfCode;
+        }
+    }
+    ++curr_idx;
+    return cnt == 0;
+}
+
+Token Lexer::NextToken() {
+    // blanks and comments are skipped in a loop rather than by recursion,
+    // so megabytes of them don't grow the stack
+    while (true) {
+        curr_idx = SkipBlanks(source_code, curr_idx, lineOfCode);
+        if (curr_idx == source_code.size()) {
+            return Token{TokenType::EOFILE, "", lineOfCode};
+        }
+        char curr_symbol = source_code[curr_idx];
+        char next_symbol = (curr_idx + 1 != source_code.size()) ? source_code[curr_idx + 1] : '#';
+
+        if (curr_symbol == '-' && next_symbol == '-') {
+            ParseLineComment();
+        } else if (curr_symbol == '(' && next_symbol == '*') {
+            if (!ParseMultiLineComment()) {
+                return Token{TokenType::ERROR, "EOF in comment", lineOfCode};
+            }
+        } else if (HasClass(curr_symbol, kDigit)) {
+            return ParseInteger();
+        } else if (HasClass(curr_symbol, kAlpha)) {
+            return ParseIdentifier();
+        } else if (curr_symbol == '"') {
+            return ParseString();
+        } else {
+            return ParsePunctuation();
+        }
+    }
+}
+
+void Lexer::PrintResult() {
+    Token token;
+    while ((token = NextToken()).tokenType != TokenType::EOFILE && token.tokenType != TokenType::ERROR) {
+        std::cout << token << '\n';
+    }
+    if (token.tokenType == TokenType::ERROR) {
+        std::cout << token << '\n';
+    }
+}
+
+void Lexer::CollectResult(std::vector<Token>& tokens) {
+    Token token;
+    while ((token = NextToken()).tokenType != TokenType::EOFILE && token.tokenType != TokenType::ERROR) {
+        tokens.push_back(token);
+    }
+    if (token.tokenType == TokenType::ERROR) {
+        tokens.push_back(token);
+    }
+}
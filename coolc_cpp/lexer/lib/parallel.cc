@@ -0,0 +1,45 @@
+#include "lexer/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <thread>
+#include <vector>
+
+void ParallelFor(std::size_t count, std::size_t jobs, const std::function<void(std::size_t)>& task) {
+    jobs = std::min(jobs, count);
+    if (jobs <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next = 0;
+    auto worker = [&] {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(jobs - 1);
+    for (std::size_t i = 1; i < jobs; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+bool ParseJobs(std::string_view arg, std::size_t& jobs) {
+    auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), jobs);
+    if (ec != std::errc() || end != arg.data() + arg.size()) {
+        return false;
+    }
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#include "lexer/source_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceFile::~SourceFile() {
+    Close();
+}
+
+bool SourceFile::Open(const std::string& filename) {
+    Close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    bool status = true;
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* mapping = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // the lexer is a single forward pass
+            ::madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+            mapping_ = mapping;
+            size_ = st.st_size;
+        } else {
+            status = ReadChunked(fd);
+        }
+    } else if (!S_ISREG(st.st_mode)) {
+        status = ReadChunked(fd);
+    }
+
+    ::close(fd);
+    return status;
+}
+
+void SourceFile::Close() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, size_);
+        mapping_ = nullptr;
+    }
+    size_ = 0;
+    buffer_.clear();
+}
+
+bool SourceFile::ReadChunked(int fd) {
+    const std::size_t chunk = ::sysconf(_SC_PAGESIZE) * 16;
+    std::size_t size = 0;
+    while (true) {
+        buffer_.resize(size + chunk);
+        ssize_t n = ::read(fd, buffer_.data() + size, chunk);
+        if (n < 0) {
+            buffer_.clear();
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        size += n;
+    }
+    buffer_.resize(size);
+    return true;
+}
@@ -0,0 +1,48 @@
+#include "lexer/symbol.h"
+
+#include <array>
+
+SymbolTable& SymbolTable::Global() {
+    static SymbolTable table;
+    return table;
+}
+
+namespace {
+
+// slots of the per-thread cache in front of the table, a power of two
+const std::size_t RECENT_SYMBOLS = 1024;
+
+}  // namespace
+
+const SymbolTable::Entry* SymbolTable::Intern(std::string_view text) {
+    // Entries never move or die, so every thread keeps the ones it got last
+    // in a small direct-mapped cache and finds them again without the lock:
+    // the few identifiers and keywords that make up most tokens stay there,
+    // and the cache costs a thread 8 KiB however many symbols there are.
+    thread_local std::array<const Entry*, RECENT_SYMBOLS> recent{};
+    const Entry*& slot = recent[std::hash<std::string_view>{}(text) & (RECENT_SYMBOLS - 1)];
+    if (slot == nullptr || slot->text != text) {
+        slot = InternShared(text);
+    }
+    return slot;
+}
+
+const SymbolTable::Entry* SymbolTable::InternShared(std::string_view text) {
+    std::lock_guard lock(mutex_);
+    if (auto it = index_.find(text); it != index_.end()) {
+        return it->second;
+    }
+    const Entry& entry = entries_.emplace_back(Entry{std::string(text), static_cast<uint32_t>(entries_.size())});
+    index_.emplace(entry.text, &entry);
+    return &entry;
+}
+
+const SymbolTable::Entry* SymbolTable::Find(uint32_t id) const {
+    std::lock_guard lock(mutex_);
+    return id < entries_.size() ? &entries_[id] : nullptr;
+}
+
+std::size_t SymbolTable::Size() const {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
@@ -0,0 +1,93 @@
+#include "lexer/token_source.h"
+
+#include <algorithm>
+
+std::size_t VectorTokenSource::Read(Token* out, std::size_t capacity) {
+    const std::size_t count = std::min(capacity, tokens_.size() - pos_);
+    std::copy_n(tokens_.begin() + pos_, count, out);
+    pos_ += count;
+    return count;
+}
+
+std::size_t StreamTokenSource::Read(Token* out, std::size_t capacity) {
+    std::size_t count = 0;
+    while (count != capacity && in_ >> out[count]) {
+        ++count;
+    }
+    return count;
+}
+
+std::size_t LexerTokenSource::Read(Token* out, std::size_t capacity) {
+    std::size_t count = 0;
+    while (count != capacity) {
+        if (!lexer_) {
+            if (fileIdx_ == filenames_.size() || !failedFile_.empty()) {
+                break;
+            }
+            const std::string& filename = filenames_[fileIdx_++];
+            lexer_ = std::make_unique<Lexer>();
+            if (!lexer_->ReadFile(filename)) {
+                failedFile_ = filename;
+                lexer_.reset();
+                break;
+            }
+            out[count++] = Token{TokenType::PROGRAM, filename, 0};
+            continue;
+        }
+
+        Token token = lexer_->NextToken();
+        if (token.tokenType == TokenType::EOFILE) {
+            lexer_.reset();
+            continue;
+        }
+        if (token.tokenType == TokenType::ERROR) {
+            lexer_.reset();
+        }
+        out[count++] = std::move(token);
+    }
+    return count;
+}
+
+void TokenRing::Write(const Token* tokens, std::size_t count) {
+    while (count != 0) {
+        std::unique_lock lock(mutex_);
+        notFull_.wait(lock, [this] { return size_ != ring_.size(); });
+        std::size_t written = 0;
+        for (; written != count && size_ != ring_.size(); ++written, ++size_) {
+            ring_[(head_ + size_) % ring_.size()] = tokens[written];
+        }
+        tokens += written;
+        count -= written;
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+}
+
+void TokenRing::Close() {
+    {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+    }
+    notEmpty_.notify_all();
+}
+
+std::size_t TokenRing::Read(Token* out, std::size_t capacity) {
+    std::unique_lock lock(mutex_);
+    notEmpty_.wait(lock, [this] { return size_ != 0 || closed_; });
+    std::size_t count = 0;
+    for (; count != capacity && size_ != 0; ++count, --size_) {
+        out[count] = std::move(ring_[head_]);
+        head_ = (head_ + 1) % ring_.size();
+    }
+    lock.unlock();
+    notFull_.notify_one();
+    return count;
+}
+
+void TokenRing::Pump(TokenSource& source, std::size_t batchSize) {
+    std::vector<Token> batch(batchSize);
+    while (std::size_t count = source.Read(batch.data(), batch.size())) {
+        Write(batch.data(), count);
+    }
+    Close();
+}
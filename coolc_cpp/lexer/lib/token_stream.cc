@@ -0,0 +1,75 @@
+#include "lexer/token_stream.h"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+bool IsBinaryTokenStream(std::string_view data) {
+    return data.size() >= sizeof(TokenStreamHeader) &&
+           std::memcmp(data.data(), TOKEN_STREAM_MAGIC, sizeof(TOKEN_STREAM_MAGIC)) == 0;
+}
+
+void WriteTokenStream(std::FILE* out, const std::vector<Token>& tokens) {
+    std::vector<TokenRecord> records;
+    records.reserve(tokens.size());
+    std::string pool;
+    std::unordered_map<Symbol, uint32_t> offsets;
+
+    for (const auto& token : tokens) {
+        auto [it, inserted] = offsets.try_emplace(token.rawValue, pool.size());
+        if (inserted) {
+            pool += token.rawValue.view();
+        }
+        records.push_back(TokenRecord{static_cast<uint32_t>(token.tokenType),
+                                      static_cast<uint32_t>(token.lineOfCode),
+                                      it->second,
+                                      static_cast<uint32_t>(token.rawValue.view().size())});
+    }
+
+    TokenStreamHeader header{};
+    std::memcpy(header.magic, TOKEN_STREAM_MAGIC, sizeof(header.magic));
+    header.version = TOKEN_STREAM_VERSION;
+    header.tokenCount = records.size();
+    header.poolSize = pool.size();
+
+    std::fwrite(&header, sizeof(header), 1, out);
+    std::fwrite(records.data(), sizeof(TokenRecord), records.size(), out);
+    std::fwrite(pool.data(), 1, pool.size(), out);
+    std::fflush(out);
+}
+
+bool ReadTokenStream(std::string_view data, std::vector<Token>& tokens) {
+    if (!IsBinaryTokenStream(data)) {
+        return false;
+    }
+    TokenStreamHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.version != TOKEN_STREAM_VERSION) {
+        return false;
+    }
+    const std::size_t recordsSize = std::size_t(header.tokenCount) * sizeof(TokenRecord);
+    if (data.size() < sizeof(header) + recordsSize + header.poolSize) {
+        return false;
+    }
+    const char* records = data.data() + sizeof(header);
+    const std::string_view pool = data.substr(sizeof(header) + recordsSize, header.poolSize);
+
+    // equal values share a pool slice, so each distinct one is interned once
+    std::unordered_map<uint64_t, Symbol> symbols;
+    tokens.reserve(tokens.size() + header.tokenCount);
+    for (uint32_t i = 0; i < header.tokenCount; ++i) {
+        TokenRecord record;
+        std::memcpy(&record, records + i * sizeof(TokenRecord), sizeof(record));
+        if (record.tokenType > static_cast<uint32_t>(TokenType::EOFILE) ||
+            std::size_t(record.offset) + record.length > pool.size()) {
+            return false;
+        }
+        const uint64_t slice = (uint64_t(record.offset) << 32) | record.length;
+        auto it = symbols.find(slice);
+        if (it == symbols.end()) {
+            it = symbols.emplace(slice, Symbol(pool.substr(record.offset, record.length))).first;
+        }
+        tokens.push_back(Token{static_cast<TokenType>(record.tokenType), it->second, record.lineOfCode});
+    }
+    return true;
+}
@@ -1,17 +1,106 @@
-#include "lexer.h"
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include "lexer/lexer.h"
+#include "lexer/parallel.h"
+#include "lexer/token_stream.h"
+
+// Result of lexing one file on a worker, printed later in argv order.
+struct LexedFile {
+    bool opened = false;
+    std::vector<Token> tokens;  // -b
+    std::string text;
+};
+
+const char* USAGE = "Usage: ./lexer [-b] [-j N] [files ..]";
 
 int main(int argc, char **argv) {
-    if (argc == 1) {
-        std::cerr << "WARN: There are not input files. Usage: ./lexer [files ..]" << std::endl;
+    bool binary = false;
+    std::size_t jobs = 1;
+    std::vector<std::string> filenames;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-b") {
+            binary = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            if (!ParseJobs(argv[++i], jobs)) {
+                std::cerr << USAGE << std::endl;
+                return 1;
+            }
+        } else if (arg.starts_with("-j") && arg.size() > 2) {
+            if (!ParseJobs(std::string_view(arg).substr(2), jobs)) {
+                std::cerr << USAGE << std::endl;
+                return 1;
+            }
+        } else {
+            filenames.push_back(arg);
+        }
+    }
+
+    if (filenames.empty()) {
+        std::cerr << "WARN: There are not input files. " << USAGE << std::endl;
         return 0;
     }
 
-    for (int i = 1; i < argc; ++i) {
-        std::string filename = argv[i];
-        std::cout << "#name \"" << filename << "\"" << std::endl;
+    if (jobs > 1) {
+        std::vector<LexedFile> files(filenames.size());
+        ParallelFor(filenames.size(), jobs, [&](std::size_t i) {
+            Lexer lex;
+            if (!(files[i].opened = lex.ReadFile(filenames[i]))) {
+                return;
+            }
+            lex.CollectResult(files[i].tokens);
+            if (!binary) {
+                std::ostringstream out;
+                out << "#name \"" << filenames[i] << "\"\n";
+                for (const auto& token : files[i].tokens) {
+                    out << token << '\n';
+                }
+                files[i].text = std::move(out).str();
+                files[i].tokens.clear();
+            }
+        });
+
+        // same output and the same stop on a missing file as the serial run
+        std::vector<Token> tokens;
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            if (!files[i].opened) {
+                std::cout.flush();
+                std::cerr << "Could not open input file " << filenames[i] << std::endl;
+                return 1;
+            }
+            if (binary) {
+                tokens.push_back(Token{TokenType::PROGRAM, filenames[i], 0});
+                tokens.insert(tokens.end(), files[i].tokens.begin(), files[i].tokens.end());
+            } else {
+                std::cout << files[i].text;
+            }
+        }
+        if (binary) {
+            WriteTokenStream(stdout, tokens);
+        }
+        return 0;
+    }
+
+    std::vector<Token> tokens;
+    for (const auto& filename : filenames) {
         Lexer lex;
-        lex.ReadFile(filename);
-        lex.PrintResult();
+        if (!lex.ReadFile(filename)) {
+            std::cerr << "Could not open input file " << filename << std::endl;
+            return 1;
+        }
+        if (binary) {
+            tokens.push_back(Token{TokenType::PROGRAM, filename, 0});
+            lex.CollectResult(tokens);
+        } else {
+            std::cout << "#name \"" << filename << "\"" << std::endl;
+            lex.PrintResult();
+        }
+    }
+
+    if (binary) {
+        WriteTokenStream(stdout, tokens);
     }
 
     return 0;
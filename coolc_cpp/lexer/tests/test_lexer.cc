@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdio>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -21,9 +22,9 @@ std::string exec(const char* cmd) {
     return result;
 }
 
-void compare_lexers(const std::vector<std::string>& files) {
+void compare_lexers(const std::vector<std::string>& files, const std::string& flags = "") {
     const std::string original_lexer = "../../resource/bin/lexer";
-    const std::string lexer = "./lexer";
+    const std::string lexer = "./lexer " + flags;
 
     std::ostringstream imploded;
     std::copy(files.begin(), files.end(),
@@ -74,9 +75,42 @@ TEST(EndToEnd, MultipleFileInput) {
     compare_lexers({first_file, second_file});
 }
 
+TEST(EndToEnd, ParallelMultipleFileInput) {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator("../../../examples")) {
+        files.push_back(entry.path());
+    }
+    compare_lexers(files, "-j 4");
+}
+
 TEST(EndToEnd, OriginalCourseTest) {
     const std::string path = "../../lexer/tests/end-to-end";
     for (const auto& entry : std::filesystem::directory_iterator(path)) {
         compare_lexers({entry.path()});
     }
 }
+
+TEST(EndToEnd, HugeBlanksAndComments) {
+    // twice_512_nested_comments.cl.cool scaled up: megabytes of blanks and
+    // comments between tokens used to cost one NextToken frame per byte
+    const std::string path = std::filesystem::temp_directory_path() / "huge_blanks_and_comments.cl";
+    {
+        std::ofstream out(path);
+        out << "class Main {\n";
+        out << std::string(4 << 20, ' ') << std::string(1 << 20, '\n');
+        for (int i = 0; i < 100000; ++i) {
+            out << "-- line comment " << i << "\n\t\f\r\v";
+        }
+        for (int i = 0; i < 2; ++i) {
+            for (int depth = 0; depth < 512; ++depth) {
+                out << "(* level " << depth << "\n";
+            }
+            for (int depth = 0; depth < 512; ++depth) {
+                out << " *)";
+            }
+        }
+        out << "};\n";
+    }
+    compare_lexers({path});
+    std::filesystem::remove(path);
+}
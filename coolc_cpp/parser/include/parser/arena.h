@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump-pointer allocator that owns all nodes of a Program. Nodes are never
+// freed one by one: everything goes at once when the arena is destroyed,
+// running the destructors of the nodes that have one.
+class Arena {
+   public:
+    Arena() = default;
+    ~Arena() { Clear(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& other) noexcept { *this = std::move(other); }
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            blocks_ = std::move(other.blocks_);
+            destructors_ = std::move(other.destructors_);
+            current_ = std::exchange(other.current_, nullptr);
+            end_ = std::exchange(other.end_, nullptr);
+            other.blocks_.clear();
+            other.destructors_.clear();
+        }
+        return *this;
+    }
+
+    template <class T, class... Args>
+    T* make(Args&&... args) {
+        T* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back({object, [](void* ptr) { static_cast<T*>(ptr)->~T(); }});
+        }
+        return object;
+    }
+
+    // `size` value-initialized items, for the child lists of nodes: a node
+    // that keeps its list here rather than in a vector needs no destructor
+    template <class T>
+    std::span<T> makeSpan(std::size_t size) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (size == 0) {
+            return {};
+        }
+        T* items = static_cast<T*>(Allocate(sizeof(T) * size, alignof(T)));
+        std::uninitialized_value_construct_n(items, size);
+        return {items, size};
+    }
+
+    // a copy of [first, last)
+    template <class It>
+    std::span<std::iter_value_t<It>> makeSpan(It first, It last) {
+        auto items = makeSpan<std::iter_value_t<It>>(static_cast<std::size_t>(std::distance(first, last)));
+        std::copy(first, last, items.begin());
+        return items;
+    }
+
+    // bytes taken from the heap, give or take a list bigger than a block:
+    // a bound on how many nodes the arena holds
+    std::size_t Capacity() const { return blocks_.size() * BLOCK_SIZE; }
+
+    // takes over the nodes of `other`, which stay where they are
+    void Merge(Arena&& other) {
+        for (auto& block : other.blocks_) {
+            blocks_.push_back(std::move(block));
+        }
+        destructors_.insert(destructors_.end(), other.destructors_.begin(), other.destructors_.end());
+        other.blocks_.clear();
+        other.destructors_.clear();
+        other.current_ = other.end_ = nullptr;
+    }
+
+   private:
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    void* Allocate(std::size_t size, std::size_t align) {
+        std::size_t padding = -reinterpret_cast<std::uintptr_t>(current_) & (align - 1);
+        if (current_ == nullptr || padding + size > static_cast<std::size_t>(end_ - current_)) {
+            const std::size_t blockSize = std::max(BLOCK_SIZE, size + align);
+            blocks_.push_back(std::make_unique<std::byte[]>(blockSize));
+            current_ = blocks_.back().get();
+            end_ = current_ + blockSize;
+            padding = -reinterpret_cast<std::uintptr_t>(current_) & (align - 1);
+        }
+        void* memory = current_ + padding;
+        current_ += padding + size;
+        return memory;
+    }
+
+    void Clear() {
+        // reverse order of construction, like automatic objects
+        for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+            it->second(it->first);
+        }
+        destructors_.clear();
+        blocks_.clear();
+        current_ = end_ = nullptr;
+    }
+
+   private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::vector<std::pair<void*, void (*)(void*)>> destructors_;
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+};
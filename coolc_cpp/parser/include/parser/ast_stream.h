@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "parser/syntax.h"
+
+// Binary form of a Program: what `parser -b` writes and the parse cache
+// stores. The text dump of PrintProgram stays the format shared with the
+// reference tools. Every section is 4-byte aligned, and a stream can be read
+// in place (see AstView), e.g. straight from a mapped file.
+//
+// Layout (native byte order):
+//   AstStreamHeader
+//   ClassRecord[header.classCount]
+//   FeatureRecord[header.featureCount]  features of a class are consecutive
+//   FormalRecord[header.formalCount]    so are formals of a method
+//   NodeRecord[header.nodeCount]        expressions, children before parents
+//   uint32_t[header.listSize]           node lists: a length, then node indices
+//   SymbolRecord[header.symbolCount]
+//   char[header.poolSize]               string pool, every symbol once
+//
+// Symbol fields are indices of SymbolRecords, node fields indices of
+// NodeRecords, list fields offsets into the lists.
+struct AstStreamHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t classCount;
+    uint32_t featureCount;
+    uint32_t formalCount;
+    uint32_t nodeCount;
+    uint32_t listSize;
+    uint32_t symbolCount;
+    uint32_t poolSize;
+};
+
+struct ClassRecord {
+    uint32_t id;
+    uint32_t baseClass;
+    uint32_t filename;
+    uint32_t lineOfCode;
+    uint32_t firstFeature;
+    uint32_t featureCount;
+};
+
+struct FeatureRecord {
+    uint32_t id;
+    uint32_t type;
+    uint32_t expr;
+    uint32_t lineOfCode;
+    uint32_t isAttr;
+    uint32_t firstFormal;
+    uint32_t formalCount;
+};
+
+struct FormalRecord {
+    uint32_t id;
+    uint32_t type;
+    uint32_t lineOfCode;
+};
+
+enum class AstNodeKind : uint32_t {
+    NEG, NOT, ISVOID,                              // fields: rhs
+    PLUS, SUB, MUL, DIV, EQ, LE, LESS,             // lhs, rhs
+    ASSIGN,                                        // id, expr
+    INT, STRING, BOOL, IDENTIFIER,                 // value (the bits of an int)
+    BLOCK,                                         // list of exprs
+    COND,                                          // predicat, trueExpr, falseExpr
+    WHILE,                                         // predicat, trueExpr
+    CASE,                                          // expr, list of BRANCHes
+    LET,                                           // id, type, expr, inExpr
+    NEW,                                           // type
+    NO_EXPR,
+    DISPATCH,                                      // obj, type, id, list of arguments
+    BRANCH,                                        // id, type, expr
+};
+
+struct NodeRecord {
+    AstNodeKind kind;
+    uint32_t lineOfCode;
+    uint32_t type;
+    uint32_t fields[4];
+};
+
+struct SymbolRecord {
+    uint32_t offset;
+    uint32_t length;
+};
+
+inline constexpr char AST_STREAM_MAGIC[8] = {'C', 'O', 'O', 'L', 'A', 'S', 'T', '\0'};
+inline constexpr uint32_t AST_STREAM_VERSION = 1;
+
+// Read-only access to the records of an AST stream where it lies, without
+// building any nodes. Open() checks every index in the stream once, so the
+// accessors don't; the data must outlive the view.
+class AstView {
+   public:
+    // false if `data` isn't a well-formed AST stream
+    bool Open(std::string_view data);
+
+    const AstStreamHeader& Header() const { return header_; }
+    ClassRecord GetClass(uint32_t idx) const { return Get<ClassRecord>(classes_, idx); }
+    FeatureRecord GetFeature(uint32_t idx) const { return Get<FeatureRecord>(features_, idx); }
+    FormalRecord GetFormal(uint32_t idx) const { return Get<FormalRecord>(formals_, idx); }
+    NodeRecord GetNode(uint32_t idx) const { return Get<NodeRecord>(nodes_, idx); }
+    // the node list at `offset`
+    uint32_t ListSize(uint32_t offset) const { return Get<uint32_t>(lists_, offset); }
+    uint32_t ListItem(uint32_t offset, uint32_t idx) const { return Get<uint32_t>(lists_, offset + 1 + idx); }
+    std::string_view SymbolText(uint32_t idx) const;
+
+   private:
+    bool Validate() const;
+
+    // copied out rather than cast in place, the data may be unaligned
+    template <class T>
+    static T Get(const char* section, std::size_t idx) {
+        T record;
+        std::memcpy(&record, section + idx * sizeof(T), sizeof(T));
+        return record;
+    }
+
+   private:
+    AstStreamHeader header_{};
+    const char* classes_ = nullptr;
+    const char* features_ = nullptr;
+    const char* formals_ = nullptr;
+    const char* nodes_ = nullptr;
+    const char* lists_ = nullptr;
+    const char* symbols_ = nullptr;
+    const char* pool_ = nullptr;
+};
+
+void WriteAst(std::string& out, const Program& program);
+// Builds the classes of the stream into program: they are appended to
+// program.classes, the nodes are allocated in program.arena. Every valid
+// line number is moved down by `lineOffset` on the way.
+void ReadAst(const AstView& view, Program& program, std::size_t lineOffset = 0);
+// same, false if `data` isn't a well-formed AST stream
+bool ReadAst(std::string_view data, Program& program, std::size_t lineOffset = 0);
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "parser/ast_stream.h"
+#include "parser/syntax.h"
+
+// The expressions of a Program as parallel arrays, one entry per node in
+// every array: no pointers, no variant, 21 bytes a node against the 64 of an
+// Expression (plus the child lists of blocks, cases and dispatches). Nodes are
+// numbered in pre-order, so a walk reads the arrays front to back and the
+// first child of a node is the node after it; siblings are linked in the
+// order the dump lists them. The branches of a case are BRANCH nodes of
+// their own, under the case.
+// Symbols are indices into a table of the AST's own.
+//
+// What each node keeps in its two symbol slots:
+//   name          ASSIGN, LET, BRANCH, DISPATCH: the id
+//                 IDENTIFIER, STRING: the value, NEW: the type
+//                 INT, BOOL: the value itself, not a symbol
+//   declaredType  LET, BRANCH: the type, DISPATCH: the static type or ""
+class FlatAst {
+   public:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    // A node is an index into the arrays; handles are passed by value.
+    class Node {
+       public:
+        Node() = default;
+        Node(const FlatAst* ast, uint32_t idx) : ast_(ast), idx_(idx) {}
+
+        explicit operator bool() const { return idx_ != NO_NODE; }
+        uint32_t Index() const { return idx_; }
+
+        AstNodeKind Kind() const { return static_cast<AstNodeKind>(ast_->kinds_[idx_]); }
+        std::size_t LineOfCode() const { return ast_->lines_[idx_]; }
+        Symbol Type() const { return ast_->symbols_[ast_->types_[idx_]]; }
+        Symbol Name() const { return ast_->symbols_[ast_->names_[idx_]]; }
+        Symbol DeclaredType() const { return ast_->symbols_[ast_->declaredTypes_[idx_]]; }
+        int32_t IntValue() const { return static_cast<int32_t>(ast_->names_[idx_]); }
+        bool BoolValue() const { return ast_->names_[idx_] != 0; }
+
+        Node FirstChild() const { return Node(ast_, IsLeaf(Kind()) ? NO_NODE : idx_ + 1); }
+        Node NextSibling() const { return Node(ast_, ast_->nextSibling_[idx_]); }
+
+       private:
+        const FlatAst* ast_ = nullptr;
+        uint32_t idx_ = NO_NODE;
+    };
+
+    struct FlatFeature {
+        Symbol id;
+        Symbol type;
+        std::size_t lineOfCode;
+        bool isAttr;
+        uint32_t firstFormal;
+        uint32_t formalCount;
+        uint32_t expr;
+    };
+
+    struct FlatClass {
+        Symbol id;
+        Symbol baseClass;
+        Symbol filename;
+        std::size_t lineOfCode;
+        uint32_t firstFeature;
+        uint32_t featureCount;
+    };
+
+    // one linear pass over the tree the parser built
+    explicit FlatAst(const Program& program);
+
+    const std::vector<FlatClass>& Classes() const { return classes_; }
+    const FlatFeature& GetFeature(uint32_t idx) const { return features_[idx]; }
+    const Formal& GetFormal(uint32_t idx) const { return formals_[idx]; }
+    Node Expr(const FlatFeature& feature) const { return Node(this, feature.expr); }
+    std::size_t NodeCount() const { return kinds_.size(); }
+
+   private:
+    // literals, identifiers, `new` and no_expr; every other node has at
+    // least one child
+    static bool IsLeaf(AstNodeKind kind) {
+        switch (kind) {
+            case AstNodeKind::INT:
+            case AstNodeKind::STRING:
+            case AstNodeKind::BOOL:
+            case AstNodeKind::IDENTIFIER:
+            case AstNodeKind::NEW:
+            case AstNodeKind::NO_EXPR: return true;
+            default: return false;
+        }
+    }
+
+    // fills the arrays in one pass over the tree
+    class Builder;
+    friend class Builder;
+
+   private:
+    std::vector<uint8_t> kinds_;
+    std::vector<uint32_t> lines_;
+    std::vector<uint32_t> nextSibling_;
+    std::vector<uint32_t> names_;
+    std::vector<uint32_t> declaredTypes_;
+    std::vector<uint32_t> types_;
+
+    std::vector<Symbol> symbols_;
+    std::vector<FlatClass> classes_;
+    std::vector<FlatFeature> features_;
+    std::vector<Formal> formals_;
+};
+
+// Depth-first walk over a flat tree, with the callbacks of Walk in
+// visitor.h. The stack holds a handle per open node, nothing else is
+// looked up: a child is the next sibling of the one before it.
+template <class State, class Visitor>
+void Walk(FlatAst::Node root, State state, Visitor& visitor) {
+    struct Frame {
+        FlatAst::Node node;
+        FlatAst::Node next;
+        std::size_t idx;
+        State state;
+    };
+    std::vector<Frame> stack;
+    visitor.Enter(root, state);
+    stack.push_back(Frame{root, root.FirstChild(), 0, std::move(state)});
+
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        if (!top.next) {
+            visitor.Leave(top.node, top.state);
+            stack.pop_back();
+            continue;
+        }
+        const FlatAst::Node child = top.next;
+        top.next = child.NextSibling();
+        State childState = visitor.Child(top.node, top.idx++, top.state);
+        visitor.Enter(child, childState);
+        // `top` dangles once the stack grows
+        stack.push_back(Frame{child, child.FirstChild(), 0, std::move(childState)});
+    }
+}
+
+// The dump of the reference parser. PrintProgram(program) flattens the
+// program and prints it with this: the walk reads the arrays in order
+// rather than chasing the nodes of the arena.
+void PrintProgram(const FlatAst& ast);
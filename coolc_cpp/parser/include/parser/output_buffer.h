@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "lexer/symbol.h"
+
+// Append-only text buffer for the AST dump. It goes to the file in large
+// chunks rather than a write per line, and indentation is sliced out of a
+// static run of spaces instead of being allocated.
+class OutputBuffer {
+   public:
+    explicit OutputBuffer(std::FILE* out) : out_(out) { buffer_.reserve(FLUSH_SIZE + FLUSH_SIZE / 4); }
+    ~OutputBuffer() { Flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // like the reference dump, indentation stops growing at PADDING.size()
+    OutputBuffer& Indent(std::size_t offset) {
+        buffer_ += PADDING.substr(0, std::min(offset, PADDING.size()));
+        return *this;
+    }
+
+    OutputBuffer& operator<<(std::string_view text) {
+        buffer_ += text;
+        return *this;
+    }
+    OutputBuffer& operator<<(const char* text) { return *this << std::string_view(text); }
+    OutputBuffer& operator<<(const Symbol& symbol) { return *this << symbol.view(); }
+
+    // a line is complete: the only point where the buffer may be flushed
+    OutputBuffer& operator<<(char c) {
+        buffer_ += c;
+        if (c == '\n' && buffer_.size() >= FLUSH_SIZE) {
+            Flush();
+        }
+        return *this;
+    }
+
+    template <std::integral T>
+        requires(!std::same_as<T, char> && !std::same_as<T, bool>)
+    OutputBuffer& operator<<(T value) {
+        char digits[24];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer_.append(digits, end);
+        return *this;
+    }
+
+    void Flush() {
+        std::fwrite(buffer_.data(), 1, buffer_.size(), out_);
+        std::fflush(out_);
+        buffer_.clear();
+    }
+
+   private:
+    static constexpr std::size_t FLUSH_SIZE = 64 * 1024;
+    static constexpr std::string_view PADDING =
+        "                                        "
+        "                                        ";
+
+    std::FILE* out_;
+    std::string buffer_;
+};
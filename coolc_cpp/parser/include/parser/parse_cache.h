@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include "lexer/token.h"
+#include "parser/syntax.h"
+
+// On-disk cache of parsed classes, for incremental builds. The token stream
+// is cut into one range per class, each range is looked up by a hash of its
+// tokens, and only the misses are parsed (and then stored, as an AST
+// stream). Lines are hashed and stored relative to the `class` keyword, so a
+// class moved by an edit above it is still a hit.
+class ParseCache {
+   public:
+    explicit ParseCache(std::filesystem::path directory) : directory_(std::move(directory)) {}
+
+    // The same Program as Parser(tokens).parseProgram(), on `jobs` threads.
+    // False if the tokens don't split into classes that parse on their own:
+    // the caller parses them as a whole then, which reports the errors.
+    bool Parse(const std::vector<Token>& tokens, std::size_t jobs, Program& program);
+
+    // classes loaded from the cache and parsed, by the last Parse()
+    std::size_t Hits() const { return hits_; }
+    std::size_t Misses() const { return misses_; }
+
+   private:
+    struct ClassRange {
+        std::size_t begin;
+        std::size_t end;
+        Symbol filename;
+    };
+
+    bool ParseClass(const std::vector<Token>& tokens, const ClassRange& range, Program& program);
+
+   private:
+    std::filesystem::path directory_;
+    std::atomic<std::size_t> hits_ = 0;
+    std::atomic<std::size_t> misses_ = 0;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lexer/token.h"
+#include "lexer/token_source.h"
+#include "parser/syntax.h"
+
+// One token of lookahead over a TokenSource. Tokens are pulled in small
+// batches, so the parser holds at most TOKEN_BATCH_SIZE of them at a time.
+// Past the end of the source it keeps yielding EOFILE.
+class TokenCursor {
+   public:
+    static constexpr std::size_t TOKEN_BATCH_SIZE = 256;
+
+    explicit TokenCursor(TokenSource& source) : source_(source) { Fill(); }
+
+    const Token& operator*() const { return buffer_[pos_]; }
+    const Token* operator->() const { return &buffer_[pos_]; }
+
+    TokenCursor& operator++() {
+        if (++pos_ == size_) {
+            Fill();
+        }
+        return *this;
+    }
+
+   private:
+    void Fill() {
+        pos_ = 0;
+        size_ = source_.Read(buffer_.data(), buffer_.size());
+        if (size_ == 0) {
+            buffer_[0] = Token{TokenType::EOFILE, "", 0};
+            size_ = 1;
+        }
+    }
+
+   private:
+    TokenSource& source_;
+    std::array<Token, TOKEN_BATCH_SIZE> buffer_;
+    std::size_t pos_ = 0;
+    std::size_t size_ = 0;
+};
+
+// Recursive descent parser. A syntax error is reported to `errors` in the
+// format of the reference parser, then parsing resumes at the next `;` of
+// the enclosing block, feature or class (`,` or `in` of a let, `)` of a
+// formal list), so one run reports every error of the input. The Program is complete
+// only if errorCount() is 0.
+class Parser {
+   public:
+    explicit Parser(TokenSource& source, std::ostream& errors = std::cerr);
+    Program parseProgram();
+    // One file of a program parsed on its own, which unlike the whole
+    // program may have no class at all.
+    Program parseFile();
+
+    std::size_t errorCount() const { return errorCount_; }
+
+   private:
+    // classes up to the end of input, at least `minClasses` of them
+    Program parseClasses(std::size_t minClasses);
+    Class* parseClass();
+    Feature* parseFeature();
+    void parseFormals(std::vector<Formal>& formals);
+    void parseFormal(std::vector<Formal>& formals);
+    // operators binding looser than or as loose as `limit` are left over
+    Expression* parseExpression(int limit = 0);
+    Expression* parsePrefix();
+    Expression* parsePrimary();
+
+    Expression* parseBlock();
+    Expression* parseLet();
+    Type parseType();
+    IdentifierExpr parseIdentifier();
+
+    Expression* parseDispatch(Expression* obj);
+    std::span<Expression*> parseArguments();
+
+    // moves to the next token, taking the file names on the way
+    void advance();
+    // reports the error at the next token (unless it follows another one too
+    // closely) and unwinds to the innermost construct that can recover
+    [[noreturn]] void syntaxError();
+    // drops tokens until `stop()`; the end of input stops the whole parse
+    template <class Stop>
+    void skipUntil(Stop stop);
+
+    // single-character token `c`
+    bool at(char c) const {
+        return next_->tokenType == TokenType::PUNCTUATION && next_->rawValue.view()[0] == c;
+    }
+
+    // every node is built once, right where it lives in the arena
+    template <class T>
+    Expression* makeExpression(T&& node, std::size_t lineOfCode) {
+        return arena_.make<Expression>(std::forward<T>(node), lineOfCode);
+    }
+
+   private:
+    TokenCursor next_;
+    Arena arena_;
+    Symbol filename_;
+
+    std::ostream& errors_;
+    std::size_t errorCount_ = 0;
+    // Tokens to shift after an error before the next one is reported, as
+    // bison does: errors right after a recovery are mostly its fallout.
+    int quietTokens_ = 0;
+    // where EOF is reported
+    std::size_t lastLineOfCode_ = 0;
+};
+
@@ -2,8 +2,15 @@
 
 #include <vector>
 #include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
 #include <variant>
 
+#include "lexer/symbol.h"
+#include "parser/arena.h"
+#include "parser/output_buffer.h"
+
 const std::size_t INVALID_LINE_OF_CODE = 1000000000;
 
 struct Expression;
@@ -13,7 +20,7 @@ struct IntExpr {
 };
 
 struct StringExpr {
-    std::string value;
+    Symbol value;
 };
 
 struct BoolExpr {
@@ -21,17 +28,17 @@ struct BoolExpr {
 };
 
 struct IdentifierExpr {
-    std::string value;
+    Symbol value;
 };
 
 struct Type {
-    std::string value;
+    Symbol value;
 };
 
 struct NoExpr {};
 
 struct UnaryExpr {
-    std::shared_ptr<Expression> rhs;
+    Expression* rhs = nullptr;
 };
 
 struct NotExpr : UnaryExpr {};
@@ -39,8 +46,8 @@ struct NegExpr : UnaryExpr {};
 struct IsVoidExpr : UnaryExpr {};
 
 struct BinaryExpr {
-    std::shared_ptr<Expression> lhs;
-    std::shared_ptr<Expression> rhs;
+    Expression* lhs = nullptr;
+    Expression* rhs = nullptr;
 };
 
 struct PlusExpr : BinaryExpr {};
@@ -53,7 +60,7 @@ struct LessExpr : BinaryExpr {};
 
 struct AssignExpr {
     IdentifierExpr id;
-    std::shared_ptr<Expression> expr;
+    Expression* expr = nullptr;
 };
 
 struct NewExpr {
@@ -61,45 +68,47 @@ struct NewExpr {
 };
 
 struct CondExpr {
-    std::shared_ptr<Expression> predicat;
-    std::shared_ptr<Expression> trueExpr;
-    std::shared_ptr<Expression> falseExpr;
+    Expression* predicat = nullptr;
+    Expression* trueExpr = nullptr;
+    Expression* falseExpr = nullptr;
 };
 
 struct WhileExpr {
-    std::shared_ptr<Expression> predicat;
-    std::shared_ptr<Expression> trueExpr;
+    Expression* predicat = nullptr;
+    Expression* trueExpr = nullptr;
 };
 
 struct LetExpr {
     IdentifierExpr id;
     Type type;
-    std::shared_ptr<Expression> expr;
-    std::shared_ptr<Expression> inExpr;
+    Expression* expr = nullptr;
+    Expression* inExpr = nullptr;
 };
 
 struct BranchExpr {
     IdentifierExpr id;
     Type type;
-    std::shared_ptr<Expression> expr;
+    Expression* expr = nullptr;
 
     std::size_t lineOfCode = INVALID_LINE_OF_CODE;
 };
 
+// The child lists below live in the arena (Arena::makeSpan), like the
+// children themselves.
 struct Case {
-    std::shared_ptr<Expression> expr;
-    std::vector<std::shared_ptr<BranchExpr>> branches;
+    Expression* expr = nullptr;
+    std::span<BranchExpr*> branches;
 };
 
 struct BlockExpr {
-    std::vector<std::shared_ptr<Expression>> exprs;
+    std::span<Expression*> exprs;
 };
 
 struct DispatchExpr {
-    std::shared_ptr<Expression> obj;
+    Expression* obj = nullptr;
     Type type;  // static dispatch
     IdentifierExpr id;
-    std::vector<std::shared_ptr<Expression>> arguments;
+    std::span<Expression*> arguments;
 };
 
 struct Expression {
@@ -117,9 +126,12 @@ struct Expression {
         data_;
 
     std::size_t lineOfCode = INVALID_LINE_OF_CODE;
-    std::string type = "_no_type";
+    Symbol type = Symbol::NoType();
 };
 
+// so the arena keeps no destructor for any expression node
+static_assert(std::is_trivially_destructible_v<Expression>);
+
 struct Formal {
     IdentifierExpr id;
     Type type;
@@ -131,7 +143,7 @@ struct Feature {
     IdentifierExpr id;
     std::vector<Formal> arguments; // for method
     Type type;
-    std::shared_ptr<Expression> expr;
+    Expression* expr = nullptr;
 
     std::size_t lineOfCode = INVALID_LINE_OF_CODE;
     bool isAttr;
@@ -140,34 +152,29 @@ struct Feature {
 struct Class {
     Type id;
     Type baseClass = Type{"Object"};
-    std::vector<std::shared_ptr<Feature>> features;
+    std::vector<Feature*> features;
 
-    std::string filename;
+    Symbol filename;
     std::size_t lineOfCode = INVALID_LINE_OF_CODE;
 };
 
 struct Program {
-    std::vector<std::shared_ptr<Class>> classes;
+    std::vector<Class*> classes;
+    // owns the classes and every node below them
+    Arena arena;
 };
 
 ///////////////// writer
-void PrintProgram(const Program& program); // only this public
-// private:
-void PrintClass(std::size_t offset, const Class& cls);
-void PrintFeature(std::size_t offset, const Feature& feature);
-void PrintFormal(std::size_t offset, const Formal& formal);
-void PrintExpression(std::size_t offset, const Expression& expression);
-void PrintBranchExpr(std::size_t offset, const BranchExpr& branch);
+// the dump of the reference parser, printed from a FlatAst (flat_ast.cc)
+void PrintProgram(const Program& program);
 
 ///////////////// reader
-Program ReadProgram(); // only this public
-// private:
-// void PrintClass(std::size_t offset, const Class& cls);
-// void PrintFeature(std::size_t offset, const Feature& feature);
-// void PrintFormal(std::size_t offset, const Formal& formal);
-// void PrintExpression(std::size_t offset, const Expression& expression);
-// void PrintBranchExpr(std::size_t offset, const BranchExpr& branch);
-
+// Reads the dump PrintProgram (and the reference parser) writes. Returns
+// false if `text` isn't one; the nodes are allocated in program.arena.
+bool ReadProgram(std::string_view text, Program& program);
+// the whole standard input, the dump or an AST stream (ast_stream.h);
+// exits on malformed input
+Program ReadProgram();
 
 // helper type for the visitor
 template <class... Ts>
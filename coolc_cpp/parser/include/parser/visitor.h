@@ -0,0 +1,63 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "parser/syntax.h"
+
+// Subexpressions of a node, in the order the dump lists them: the scrutinee
+// of a case before the branch bodies, the object of a dispatch before its
+// arguments.
+std::size_t ChildCount(const Expression& expr);
+Expression* Child(const Expression& expr, std::size_t idx);
+
+// Depth-first walk over an expression tree on an explicit stack, so the
+// depth of the tree costs heap, not native stack. Each node carries a
+// State of the visitor's choosing (an indentation, a scope, ...):
+//
+//   void  Enter(const Expression& expr, State& state);
+//   State Child(const Expression& expr, std::size_t idx, State& state);
+//       state for child idx, called right before it is walked
+//   void  Leave(const Expression& expr, State& state);
+//
+// Node is Expression or const Expression: a visitor that fills in the tree
+// (the types, say) walks it as non-const. A visitor that needs the children
+// in another order (arguments of a dispatch before its object, as they are
+// evaluated) defines
+//
+//   Node* ChildAt(Node& expr, std::size_t idx);
+template <class State, class Visitor, class Node>
+    requires std::same_as<std::remove_const_t<Node>, Expression>
+void Walk(Node& root, State state, Visitor& visitor) {
+    struct Frame {
+        Node* expr;
+        std::size_t next;
+        std::size_t count;
+        State state;
+    };
+    std::vector<Frame> stack;
+    visitor.Enter(root, state);
+    stack.push_back(Frame{&root, 0, ChildCount(root), std::move(state)});
+
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        if (top.next == top.count) {
+            visitor.Leave(*top.expr, top.state);
+            stack.pop_back();
+            continue;
+        }
+        const std::size_t idx = top.next++;
+        Node* child;
+        if constexpr (requires { visitor.ChildAt(*top.expr, idx); }) {
+            child = visitor.ChildAt(*top.expr, idx);
+        } else {
+            child = ::Child(*top.expr, idx);
+        }
+        State childState = visitor.Child(*top.expr, idx, top.state);
+        visitor.Enter(*child, childState);
+        // `top` dangles once the stack grows
+        stack.push_back(Frame{child, 0, ChildCount(*child), std::move(childState)});
+    }
+}
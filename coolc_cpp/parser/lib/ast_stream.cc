@@ -0,0 +1,473 @@
+#include "parser/ast_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "parser/visitor.h"
+
+namespace {
+
+template <class T>
+void Append(std::string& out, const std::vector<T>& records) {
+    out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+}
+
+class AstWriter {
+   public:
+    void Write(std::string& out, const Program& program) {
+        for (const Class* cls : program.classes) {
+            WriteClass(*cls);
+        }
+
+        AstStreamHeader header{};
+        std::memcpy(header.magic, AST_STREAM_MAGIC, sizeof(header.magic));
+        header.version = AST_STREAM_VERSION;
+        header.classCount = classes_.size();
+        header.featureCount = features_.size();
+        header.formalCount = formals_.size();
+        header.nodeCount = nodes_.size();
+        header.listSize = lists_.size();
+        header.symbolCount = symbolRecords_.size();
+        header.poolSize = pool_.size();
+
+        out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        Append(out, classes_);
+        Append(out, features_);
+        Append(out, formals_);
+        Append(out, nodes_);
+        Append(out, lists_);
+        Append(out, symbolRecords_);
+        out += pool_;
+    }
+
+    // Walk callbacks: a node is written when it is left, after its children,
+    // whose indices are on top of results_ by then
+    void Enter(const Expression&, char&) {}
+    char Child(const Expression&, std::size_t, char&) { return 0; }
+    void Leave(const Expression& expr, char&) {
+        const std::size_t count = ChildCount(expr);
+        const uint32_t* children = results_.data() + results_.size() - count;
+        NodeRecord record{AstNodeKind::NO_EXPR, static_cast<uint32_t>(expr.lineOfCode), SymbolIndex(expr.type), {}};
+        uint32_t* fields = record.fields;
+
+        std::visit(
+            overloaded{
+                [&](const NegExpr&) { record.kind = AstNodeKind::NEG; fields[0] = children[0]; },
+                [&](const NotExpr&) { record.kind = AstNodeKind::NOT; fields[0] = children[0]; },
+                [&](const IsVoidExpr&) { record.kind = AstNodeKind::ISVOID; fields[0] = children[0]; },
+                [&](const PlusExpr&) { SetBinary(record, AstNodeKind::PLUS, children); },
+                [&](const SubExpr&) { SetBinary(record, AstNodeKind::SUB, children); },
+                [&](const MulExpr&) { SetBinary(record, AstNodeKind::MUL, children); },
+                [&](const DivExpr&) { SetBinary(record, AstNodeKind::DIV, children); },
+                [&](const EqExpr&) { SetBinary(record, AstNodeKind::EQ, children); },
+                [&](const LeExpr&) { SetBinary(record, AstNodeKind::LE, children); },
+                [&](const LessExpr&) { SetBinary(record, AstNodeKind::LESS, children); },
+                [&](const AssignExpr& node) {
+                    record.kind = AstNodeKind::ASSIGN;
+                    fields[0] = SymbolIndex(node.id.value);
+                    fields[1] = children[0];
+                },
+                [&](const IntExpr& node) { record.kind = AstNodeKind::INT; fields[0] = static_cast<uint32_t>(node.value); },
+                [&](const StringExpr& node) { record.kind = AstNodeKind::STRING; fields[0] = SymbolIndex(node.value); },
+                [&](const BoolExpr& node) { record.kind = AstNodeKind::BOOL; fields[0] = node.value; },
+                [&](const IdentifierExpr& node) { record.kind = AstNodeKind::IDENTIFIER; fields[0] = SymbolIndex(node.value); },
+                [&](const BlockExpr&) { record.kind = AstNodeKind::BLOCK; fields[0] = List(children, count); },
+                [&](const CondExpr&) {
+                    record.kind = AstNodeKind::COND;
+                    std::copy_n(children, 3, fields);
+                },
+                [&](const WhileExpr&) {
+                    record.kind = AstNodeKind::WHILE;
+                    std::copy_n(children, 2, fields);
+                },
+                [&](const Case& node) {
+                    std::vector<uint32_t> branches;
+                    for (std::size_t i = 0; i < node.branches.size(); ++i) {
+                        const BranchExpr& branch = *node.branches[i];
+                        branches.push_back(nodes_.size());
+                        nodes_.push_back(NodeRecord{AstNodeKind::BRANCH,
+                                                    static_cast<uint32_t>(branch.lineOfCode),
+                                                    0,
+                                                    {SymbolIndex(branch.id.value), SymbolIndex(branch.type.value), children[1 + i]}});
+                    }
+                    record.kind = AstNodeKind::CASE;
+                    fields[0] = children[0];
+                    fields[1] = List(branches.data(), branches.size());
+                },
+                [&](const LetExpr& node) {
+                    record.kind = AstNodeKind::LET;
+                    fields[0] = SymbolIndex(node.id.value);
+                    fields[1] = SymbolIndex(node.type.value);
+                    fields[2] = children[0];
+                    fields[3] = children[1];
+                },
+                [&](const NewExpr& node) { record.kind = AstNodeKind::NEW; fields[0] = SymbolIndex(node.type.value); },
+                [&](const NoExpr&) { record.kind = AstNodeKind::NO_EXPR; },
+                [&](const DispatchExpr& node) {
+                    record.kind = AstNodeKind::DISPATCH;
+                    fields[0] = children[0];
+                    fields[1] = SymbolIndex(node.type.value);
+                    fields[2] = SymbolIndex(node.id.value);
+                    fields[3] = List(children + 1, count - 1);
+                },
+            },
+            expr.data_);
+
+        results_.resize(results_.size() - count);
+        results_.push_back(nodes_.size());
+        nodes_.push_back(record);
+    }
+
+   private:
+    void WriteClass(const Class& cls) {
+        ClassRecord record{SymbolIndex(cls.id.value), SymbolIndex(cls.baseClass.value), SymbolIndex(cls.filename),
+                           static_cast<uint32_t>(cls.lineOfCode), static_cast<uint32_t>(features_.size()),
+                           static_cast<uint32_t>(cls.features.size())};
+        for (const Feature* feature : cls.features) {
+            FeatureRecord out{SymbolIndex(feature->id.value), SymbolIndex(feature->type.value), 0,
+                              static_cast<uint32_t>(feature->lineOfCode), feature->isAttr,
+                              static_cast<uint32_t>(formals_.size()), static_cast<uint32_t>(feature->arguments.size())};
+            for (const Formal& formal : feature->arguments) {
+                formals_.push_back(FormalRecord{SymbolIndex(formal.id.value), SymbolIndex(formal.type.value),
+                                                static_cast<uint32_t>(formal.lineOfCode)});
+            }
+            char state = 0;
+            Walk(*feature->expr, state, *this);
+            out.expr = results_.back();
+            results_.pop_back();
+            features_.push_back(out);
+        }
+        classes_.push_back(record);
+    }
+
+    static void SetBinary(NodeRecord& record, AstNodeKind kind, const uint32_t* children) {
+        record.kind = kind;
+        record.fields[0] = children[0];
+        record.fields[1] = children[1];
+    }
+
+    uint32_t List(const uint32_t* items, std::size_t count) {
+        const uint32_t offset = lists_.size();
+        lists_.push_back(count);
+        lists_.insert(lists_.end(), items, items + count);
+        return offset;
+    }
+
+    uint32_t SymbolIndex(Symbol symbol) {
+        auto [it, inserted] = symbols_.try_emplace(symbol, symbolRecords_.size());
+        if (inserted) {
+            symbolRecords_.push_back(SymbolRecord{static_cast<uint32_t>(pool_.size()),
+                                                  static_cast<uint32_t>(symbol.view().size())});
+            pool_ += symbol.view();
+        }
+        return it->second;
+    }
+
+   private:
+    std::vector<ClassRecord> classes_;
+    std::vector<FeatureRecord> features_;
+    std::vector<FormalRecord> formals_;
+    std::vector<NodeRecord> nodes_;
+    std::vector<uint32_t> lists_;
+    std::vector<SymbolRecord> symbolRecords_;
+    std::string pool_;
+    std::unordered_map<Symbol, uint32_t> symbols_;
+
+    std::vector<uint32_t> results_;
+};
+
+// What the fields of a NodeRecord hold, by kind. The expressions of a block
+// and the branches of a case are never empty, the arguments of a dispatch may be.
+enum FieldType : uint8_t { UNUSED, NODE, SYMBOL, NODE_LIST, BODY_LIST, BRANCH_LIST, VALUE };
+
+struct FieldTypes {
+    FieldType fields[4];
+};
+
+constexpr FieldTypes KIND_FIELDS[] = {
+    {NODE}, {NODE}, {NODE},                                                  // NEG NOT ISVOID
+    {NODE, NODE}, {NODE, NODE}, {NODE, NODE}, {NODE, NODE},                  // PLUS SUB MUL DIV
+    {NODE, NODE}, {NODE, NODE}, {NODE, NODE},                                // EQ LE LESS
+    {SYMBOL, NODE},                                                          // ASSIGN
+    {VALUE}, {SYMBOL}, {VALUE}, {SYMBOL},                                    // INT STRING BOOL IDENTIFIER
+    {BODY_LIST},                                                             // BLOCK
+    {NODE, NODE, NODE},                                                      // COND
+    {NODE, NODE},                                                            // WHILE
+    {NODE, BRANCH_LIST},                                                     // CASE
+    {SYMBOL, SYMBOL, NODE, NODE},                                            // LET
+    {SYMBOL},                                                                // NEW
+    {},                                                                      // NO_EXPR
+    {NODE, SYMBOL, SYMBOL, NODE_LIST},                                       // DISPATCH
+    {SYMBOL, SYMBOL, NODE},                                                  // BRANCH
+};
+static_assert(std::size(KIND_FIELDS) == static_cast<std::size_t>(AstNodeKind::BRANCH) + 1);
+
+class AstLoader {
+   public:
+    AstLoader(const AstView& view, Arena& arena, std::size_t lineOffset)
+        : view_(view), arena_(arena), lineOffset_(lineOffset) {}
+
+    void Load(std::vector<Class*>& out) {
+        const AstStreamHeader& header = view_.Header();
+        symbols_.reserve(header.symbolCount);
+        for (uint32_t i = 0; i < header.symbolCount; ++i) {
+            symbols_.emplace_back(view_.SymbolText(i));
+        }
+        expressions_.resize(header.nodeCount);
+        branches_.resize(header.nodeCount);
+        for (uint32_t i = 0; i < header.nodeCount; ++i) {
+            LoadNode(i);
+        }
+        for (uint32_t i = 0; i < header.classCount; ++i) {
+            out.push_back(LoadClass(view_.GetClass(i)));
+        }
+    }
+
+   private:
+    std::size_t Line(uint32_t lineOfCode) const {
+        return lineOfCode == 0 || lineOfCode == INVALID_LINE_OF_CODE ? lineOfCode : lineOfCode + lineOffset_;
+    }
+
+    std::span<Expression*> Expressions(uint32_t list) const {
+        std::span<Expression*> exprs = arena_.makeSpan<Expression*>(view_.ListSize(list));
+        for (std::size_t i = 0; i < exprs.size(); ++i) {
+            exprs[i] = expressions_[view_.ListItem(list, i)];
+        }
+        return exprs;
+    }
+
+    template <class T>
+    Expression* Unary(const uint32_t* fields) const {
+        T node;
+        node.rhs = expressions_[fields[0]];
+        return arena_.make<Expression>(node);
+    }
+
+    template <class T>
+    Expression* Binary(const uint32_t* fields) const {
+        T node;
+        node.lhs = expressions_[fields[0]];
+        node.rhs = expressions_[fields[1]];
+        return arena_.make<Expression>(node);
+    }
+
+    void LoadNode(uint32_t idx) {
+        const NodeRecord record = view_.GetNode(idx);
+        const uint32_t* fields = record.fields;
+        auto node = [&](int field) { return expressions_[fields[field]]; };
+        auto symbol = [&](int field) { return symbols_[fields[field]]; };
+
+        Expression* expr = nullptr;
+        switch (record.kind) {
+            case AstNodeKind::NEG: expr = Unary<NegExpr>(fields); break;
+            case AstNodeKind::NOT: expr = Unary<NotExpr>(fields); break;
+            case AstNodeKind::ISVOID: expr = Unary<IsVoidExpr>(fields); break;
+            case AstNodeKind::PLUS: expr = Binary<PlusExpr>(fields); break;
+            case AstNodeKind::SUB: expr = Binary<SubExpr>(fields); break;
+            case AstNodeKind::MUL: expr = Binary<MulExpr>(fields); break;
+            case AstNodeKind::DIV: expr = Binary<DivExpr>(fields); break;
+            case AstNodeKind::EQ: expr = Binary<EqExpr>(fields); break;
+            case AstNodeKind::LE: expr = Binary<LeExpr>(fields); break;
+            case AstNodeKind::LESS: expr = Binary<LessExpr>(fields); break;
+            case AstNodeKind::ASSIGN: expr = arena_.make<Expression>(AssignExpr{{symbol(0)}, node(1)}); break;
+            case AstNodeKind::INT: expr = arena_.make<Expression>(IntExpr{static_cast<int32_t>(fields[0])}); break;
+            case AstNodeKind::STRING: expr = arena_.make<Expression>(StringExpr{symbol(0)}); break;
+            case AstNodeKind::BOOL: expr = arena_.make<Expression>(BoolExpr{fields[0] != 0}); break;
+            case AstNodeKind::IDENTIFIER: expr = arena_.make<Expression>(IdentifierExpr{symbol(0)}); break;
+            case AstNodeKind::BLOCK: expr = arena_.make<Expression>(BlockExpr{Expressions(fields[0])}); break;
+            case AstNodeKind::COND: expr = arena_.make<Expression>(CondExpr{node(0), node(1), node(2)}); break;
+            case AstNodeKind::WHILE: expr = arena_.make<Expression>(WhileExpr{node(0), node(1)}); break;
+            case AstNodeKind::CASE: {
+                Case caseExpr{node(0), arena_.makeSpan<BranchExpr*>(view_.ListSize(fields[1]))};
+                for (uint32_t i = 0; i < caseExpr.branches.size(); ++i) {
+                    caseExpr.branches[i] = branches_[view_.ListItem(fields[1], i)];
+                }
+                expr = arena_.make<Expression>(caseExpr);
+                break;
+            }
+            case AstNodeKind::LET:
+                expr = arena_.make<Expression>(LetExpr{{symbol(0)}, {symbol(1)}, node(2), node(3)});
+                break;
+            case AstNodeKind::NEW: expr = arena_.make<Expression>(NewExpr{{symbol(0)}}); break;
+            case AstNodeKind::NO_EXPR: expr = arena_.make<Expression>(NoExpr{}); break;
+            case AstNodeKind::DISPATCH:
+                expr = arena_.make<Expression>(
+                    DispatchExpr{node(0), {symbol(1)}, {symbol(2)}, Expressions(fields[3])});
+                break;
+            case AstNodeKind::BRANCH:
+                branches_[idx] = arena_.make<BranchExpr>(
+                    BranchExpr{{symbol(0)}, {symbol(1)}, node(2), Line(record.lineOfCode)});
+                return;
+        }
+        expr->lineOfCode = Line(record.lineOfCode);
+        expr->type = symbols_[record.type];
+        expressions_[idx] = expr;
+    }
+
+    Class* LoadClass(const ClassRecord& record) {
+        Class* cls = arena_.make<Class>();
+        cls->id.value = symbols_[record.id];
+        cls->baseClass.value = symbols_[record.baseClass];
+        cls->filename = symbols_[record.filename];
+        cls->lineOfCode = Line(record.lineOfCode);
+        for (uint32_t i = 0; i < record.featureCount; ++i) {
+            const FeatureRecord featureRecord = view_.GetFeature(record.firstFeature + i);
+            Feature* feature = arena_.make<Feature>();
+            feature->id.value = symbols_[featureRecord.id];
+            feature->type.value = symbols_[featureRecord.type];
+            feature->expr = expressions_[featureRecord.expr];
+            feature->lineOfCode = Line(featureRecord.lineOfCode);
+            feature->isAttr = featureRecord.isAttr != 0;
+            for (uint32_t j = 0; j < featureRecord.formalCount; ++j) {
+                const FormalRecord formal = view_.GetFormal(featureRecord.firstFormal + j);
+                feature->arguments.push_back(
+                    Formal{{symbols_[formal.id]}, {symbols_[formal.type]}, Line(formal.lineOfCode)});
+            }
+            cls->features.push_back(feature);
+        }
+        return cls;
+    }
+
+   private:
+    const AstView& view_;
+    Arena& arena_;
+    const std::size_t lineOffset_;
+
+    // interned once each, not once per use
+    std::vector<Symbol> symbols_;
+    // what each NodeRecord became, by index
+    std::vector<Expression*> expressions_;
+    std::vector<BranchExpr*> branches_;
+};
+
+}  // namespace
+
+bool AstView::Open(std::string_view data) {
+    if (data.size() < sizeof(AstStreamHeader) ||
+        std::memcmp(data.data(), AST_STREAM_MAGIC, sizeof(AST_STREAM_MAGIC)) != 0) {
+        return false;
+    }
+    std::memcpy(&header_, data.data(), sizeof(header_));
+    if (header_.version != AST_STREAM_VERSION) {
+        return false;
+    }
+
+    std::size_t offset = sizeof(header_);
+    auto section = [&](std::size_t size, const char*& begin) {
+        if (data.size() - offset < size) {
+            return false;
+        }
+        begin = data.data() + offset;
+        offset += size;
+        return true;
+    };
+    if (!section(std::size_t(header_.classCount) * sizeof(ClassRecord), classes_) ||
+        !section(std::size_t(header_.featureCount) * sizeof(FeatureRecord), features_) ||
+        !section(std::size_t(header_.formalCount) * sizeof(FormalRecord), formals_) ||
+        !section(std::size_t(header_.nodeCount) * sizeof(NodeRecord), nodes_) ||
+        !section(std::size_t(header_.listSize) * sizeof(uint32_t), lists_) ||
+        !section(std::size_t(header_.symbolCount) * sizeof(SymbolRecord), symbols_) ||
+        !section(header_.poolSize, pool_)) {
+        return false;
+    }
+    return Validate();
+}
+
+// Every index is checked once here, so that the accessors need not.
+bool AstView::Validate() const {
+    for (uint32_t i = 0; i < header_.symbolCount; ++i) {
+        const SymbolRecord symbol = Get<SymbolRecord>(symbols_, i);
+        if (std::size_t(symbol.offset) + symbol.length > header_.poolSize) {
+            return false;
+        }
+    }
+    auto isSymbol = [&](uint32_t idx) { return idx < header_.symbolCount; };
+    // children come before their parent
+    auto isNode = [&](uint32_t idx, uint32_t parent, bool branch) {
+        return idx < parent && (GetNode(idx).kind == AstNodeKind::BRANCH) == branch;
+    };
+    auto isList = [&](uint32_t offset, uint32_t parent, bool branches, bool nonEmpty) {
+        if (offset >= header_.listSize || ListSize(offset) > header_.listSize - offset - 1 ||
+            (nonEmpty && ListSize(offset) == 0)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < ListSize(offset); ++i) {
+            if (!isNode(ListItem(offset, i), parent, branches)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (uint32_t i = 0; i < header_.nodeCount; ++i) {
+        const NodeRecord node = GetNode(i);
+        if (static_cast<uint32_t>(node.kind) > static_cast<uint32_t>(AstNodeKind::BRANCH) ||
+            (node.kind != AstNodeKind::BRANCH && !isSymbol(node.type))) {
+            return false;
+        }
+        const FieldTypes& types = KIND_FIELDS[static_cast<uint32_t>(node.kind)];
+        for (int field = 0; field < 4; ++field) {
+            const uint32_t value = node.fields[field];
+            bool ok = true;
+            switch (types.fields[field]) {
+                case NODE: ok = isNode(value, i, false); break;
+                case SYMBOL: ok = isSymbol(value); break;
+                case NODE_LIST: ok = isList(value, i, false, false); break;
+                case BODY_LIST: ok = isList(value, i, false, true); break;
+                case BRANCH_LIST: ok = isList(value, i, true, true); break;
+                case UNUSED:
+                case VALUE: break;
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < header_.formalCount; ++i) {
+        const FormalRecord formal = GetFormal(i);
+        if (!isSymbol(formal.id) || !isSymbol(formal.type)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header_.featureCount; ++i) {
+        const FeatureRecord feature = GetFeature(i);
+        if (!isSymbol(feature.id) || !isSymbol(feature.type) || !isNode(feature.expr, header_.nodeCount, false) ||
+            feature.firstFormal > header_.formalCount || feature.formalCount > header_.formalCount - feature.firstFormal) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header_.classCount; ++i) {
+        const ClassRecord cls = GetClass(i);
+        if (!isSymbol(cls.id) || !isSymbol(cls.baseClass) || !isSymbol(cls.filename) ||
+            cls.firstFeature > header_.featureCount || cls.featureCount > header_.featureCount - cls.firstFeature) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view AstView::SymbolText(uint32_t idx) const {
+    const SymbolRecord symbol = Get<SymbolRecord>(symbols_, idx);
+    return std::string_view(pool_ + symbol.offset, symbol.length);
+}
+
+void WriteAst(std::string& out, const Program& program) {
+    AstWriter().Write(out, program);
+}
+
+void ReadAst(const AstView& view, Program& program, std::size_t lineOffset) {
+    AstLoader(view, program.arena, lineOffset).Load(program.classes);
+}
+
+bool ReadAst(std::string_view data, Program& program, std::size_t lineOffset) {
+    AstView view;
+    if (!view.Open(data)) {
+        return false;
+    }
+    ReadAst(view, program, lineOffset);
+    return true;
+}
@@ -0,0 +1,350 @@
+#include "parser/flat_ast.h"
+
+#include <iostream>
+#include <variant>
+
+#include "parser/output_buffer.h"
+
+class FlatAst::Builder {
+   public:
+    explicit Builder(FlatAst& ast) : ast_(ast) {
+        // slot 0 is the empty symbol, what a node without a name points at
+        SymbolIndex(Symbol::Empty());
+    }
+
+    void Build(const Program& program) {
+        // no node is smaller than a branch, so this many are at least enough
+        const std::size_t nodes = program.arena.Capacity() / sizeof(BranchExpr);
+        for (auto* array : {&ast_.lines_, &ast_.nextSibling_, &ast_.names_, &ast_.declaredTypes_, &ast_.types_,
+                            &lastChild_}) {
+            array->reserve(nodes);
+        }
+        ast_.kinds_.reserve(nodes);
+        for (const Class* cls : program.classes) {
+            ast_.classes_.push_back(FlatClass{cls->id.value, cls->baseClass.value, cls->filename, cls->lineOfCode,
+                                              static_cast<uint32_t>(ast_.features_.size()),
+                                              static_cast<uint32_t>(cls->features.size())});
+            for (const ::Feature* feature : cls->features) {
+                const uint32_t firstFormal = ast_.formals_.size();
+                ast_.formals_.insert(ast_.formals_.end(), feature->arguments.begin(), feature->arguments.end());
+                const uint32_t expr = ast_.kinds_.size();
+                Flatten(*feature->expr);
+                ast_.features_.push_back(FlatFeature{feature->id.value, feature->type.value, feature->lineOfCode,
+                                                     feature->isAttr, firstFormal,
+                                                     static_cast<uint32_t>(feature->arguments.size()), expr});
+            }
+        }
+    }
+
+   private:
+    // A node still to add, a branch if `expr` is null. Children go on the
+    // stack last to first, so a subtree is done before its next sibling
+    // starts and nodes come out in pre-order.
+    struct Pending {
+        const Expression* expr;
+        const BranchExpr* branch;
+        uint32_t parent;
+    };
+
+    // one visit per node, what Walk with its ChildCount/Child would triple
+    void Flatten(const Expression& root) {
+        stack_.push_back(Pending{&root, nullptr, NO_NODE});
+        while (!stack_.empty()) {
+            const Pending pending = stack_.back();
+            stack_.pop_back();
+            // the children pushed below are linked to it as their parent
+            const uint32_t idx = ast_.kinds_.size();
+            if (pending.expr == nullptr) {
+                const BranchExpr& branch = *pending.branch;
+                Push(branch.expr, idx);
+                AddNode(AstNodeKind::BRANCH, branch.lineOfCode, noType_, pending.parent, SymbolIndex(branch.id.value),
+                        SymbolIndex(branch.type.value));
+                continue;
+            }
+
+            const Expression& expr = *pending.expr;
+            AstNodeKind kind = AstNodeKind::NO_EXPR;
+            uint32_t name = 0;
+            uint32_t declaredType = 0;
+            std::visit(
+                overloaded{
+                    [&](const NegExpr& e) { kind = PushUnary(AstNodeKind::NEG, e, idx); },
+                    [&](const NotExpr& e) { kind = PushUnary(AstNodeKind::NOT, e, idx); },
+                    [&](const IsVoidExpr& e) { kind = PushUnary(AstNodeKind::ISVOID, e, idx); },
+                    [&](const PlusExpr& e) { kind = PushBinary(AstNodeKind::PLUS, e, idx); },
+                    [&](const SubExpr& e) { kind = PushBinary(AstNodeKind::SUB, e, idx); },
+                    [&](const MulExpr& e) { kind = PushBinary(AstNodeKind::MUL, e, idx); },
+                    [&](const DivExpr& e) { kind = PushBinary(AstNodeKind::DIV, e, idx); },
+                    [&](const EqExpr& e) { kind = PushBinary(AstNodeKind::EQ, e, idx); },
+                    [&](const LeExpr& e) { kind = PushBinary(AstNodeKind::LE, e, idx); },
+                    [&](const LessExpr& e) { kind = PushBinary(AstNodeKind::LESS, e, idx); },
+                    [&](const AssignExpr& e) {
+                        kind = AstNodeKind::ASSIGN;
+                        name = SymbolIndex(e.id.value);
+                        Push(e.expr, idx);
+                    },
+                    [&](const IntExpr& e) {
+                        kind = AstNodeKind::INT;
+                        name = static_cast<uint32_t>(e.value);
+                    },
+                    [&](const StringExpr& e) {
+                        kind = AstNodeKind::STRING;
+                        name = SymbolIndex(e.value);
+                    },
+                    [&](const BoolExpr& e) {
+                        kind = AstNodeKind::BOOL;
+                        name = e.value;
+                    },
+                    [&](const IdentifierExpr& e) {
+                        kind = AstNodeKind::IDENTIFIER;
+                        name = SymbolIndex(e.value);
+                    },
+                    [&](const BlockExpr& e) {
+                        kind = AstNodeKind::BLOCK;
+                        for (auto it = e.exprs.rbegin(); it != e.exprs.rend(); ++it) {
+                            Push(*it, idx);
+                        }
+                    },
+                    [&](const CondExpr& e) {
+                        kind = AstNodeKind::COND;
+                        Push(e.falseExpr, idx);
+                        Push(e.trueExpr, idx);
+                        Push(e.predicat, idx);
+                    },
+                    [&](const WhileExpr& e) {
+                        kind = AstNodeKind::WHILE;
+                        Push(e.trueExpr, idx);
+                        Push(e.predicat, idx);
+                    },
+                    [&](const Case& e) {
+                        kind = AstNodeKind::CASE;
+                        for (auto it = e.branches.rbegin(); it != e.branches.rend(); ++it) {
+                            stack_.push_back(Pending{nullptr, *it, idx});
+                        }
+                        Push(e.expr, idx);
+                    },
+                    [&](const LetExpr& e) {
+                        kind = AstNodeKind::LET;
+                        name = SymbolIndex(e.id.value);
+                        declaredType = SymbolIndex(e.type.value);
+                        Push(e.inExpr, idx);
+                        Push(e.expr, idx);
+                    },
+                    [&](const NewExpr& e) {
+                        kind = AstNodeKind::NEW;
+                        name = SymbolIndex(e.type.value);
+                    },
+                    [&](const NoExpr&) { kind = AstNodeKind::NO_EXPR; },
+                    [&](const DispatchExpr& e) {
+                        kind = AstNodeKind::DISPATCH;
+                        name = SymbolIndex(e.id.value);
+                        declaredType = SymbolIndex(e.type.value);
+                        for (auto it = e.arguments.rbegin(); it != e.arguments.rend(); ++it) {
+                            Push(*it, idx);
+                        }
+                        Push(e.obj, idx);
+                    },
+                },
+                expr.data_);
+            AddNode(kind, expr.lineOfCode, expr.type, pending.parent, name, declaredType);
+        }
+    }
+
+    void Push(const Expression* expr, uint32_t parent) { stack_.push_back(Pending{expr, nullptr, parent}); }
+
+    AstNodeKind PushUnary(AstNodeKind kind, const UnaryExpr& expr, uint32_t idx) {
+        Push(expr.rhs, idx);
+        return kind;
+    }
+
+    AstNodeKind PushBinary(AstNodeKind kind, const BinaryExpr& expr, uint32_t idx) {
+        Push(expr.rhs, idx);
+        Push(expr.lhs, idx);
+        return kind;
+    }
+
+    // Appends the node, the next sibling of the child its parent got last.
+    // The first child needs no link: it comes right after its parent.
+    void AddNode(AstNodeKind kind, std::size_t lineOfCode, Symbol type, uint32_t parent, uint32_t name,
+                 uint32_t declaredType) {
+        const uint32_t idx = ast_.kinds_.size();
+        ast_.kinds_.push_back(static_cast<uint8_t>(kind));
+        ast_.lines_.push_back(static_cast<uint32_t>(lineOfCode));
+        ast_.nextSibling_.push_back(NO_NODE);
+        ast_.names_.push_back(name);
+        ast_.declaredTypes_.push_back(declaredType);
+        ast_.types_.push_back(SymbolIndex(type));
+        lastChild_.push_back(NO_NODE);
+
+        if (parent != NO_NODE) {
+            if (lastChild_[parent] != NO_NODE) {
+                ast_.nextSibling_[lastChild_[parent]] = idx;
+            }
+            lastChild_[parent] = idx;
+        }
+    }
+
+    uint32_t SymbolIndex(Symbol symbol) {
+        if (symbol.id() >= symbolIndex_.size()) {
+            symbolIndex_.resize(symbol.id() + 1, NO_NODE);
+        }
+        uint32_t& idx = symbolIndex_[symbol.id()];
+        if (idx == NO_NODE) {
+            idx = ast_.symbols_.size();
+            ast_.symbols_.push_back(symbol);
+        }
+        return idx;
+    }
+
+   private:
+    FlatAst& ast_;
+    std::vector<Pending> stack_;
+    // the type of a branch node
+    const Symbol noType_ = Symbol::NoType();
+    // the child linked last under each node, while its children are added
+    std::vector<uint32_t> lastChild_;
+    // by the global id of a symbol, NO_NODE if it isn't in the table yet
+    std::vector<uint32_t> symbolIndex_;
+};
+
+FlatAst::FlatAst(const Program& program) {
+    Builder(*this).Build(program);
+}
+
+///////////////// printer zone
+namespace {
+
+// Prints a node on the way in, the lines between its subexpressions as they
+// come and the type on the way out. State is the indentation of the node.
+struct FlatPrinter {
+    OutputBuffer& out;
+
+    void Enter(FlatAst::Node node, std::size_t offset) {
+        out.Indent(offset) << '#' << node.LineOfCode() << '\n';
+        out.Indent(offset);
+        offset += 2;
+
+        switch (node.Kind()) {
+            case AstNodeKind::DISPATCH:
+                out << (node.DeclaredType().empty() ? "_dispatch" : "_static_dispatch") << '\n';
+                break;
+            case AstNodeKind::LET:
+            case AstNodeKind::BRANCH:
+                out << (node.Kind() == AstNodeKind::LET ? "_let" : "_branch") << '\n';
+                out.Indent(offset) << node.Name() << '\n';
+                out.Indent(offset) << node.DeclaredType() << '\n';
+                break;
+            case AstNodeKind::ASSIGN:
+                out << "_assign" << '\n';
+                out.Indent(offset) << node.Name() << '\n';
+                break;
+            case AstNodeKind::WHILE: out << "_loop" << '\n'; break;
+            case AstNodeKind::NEW:
+                out << "_new" << '\n';
+                out.Indent(offset) << node.Name() << '\n';
+                break;
+            case AstNodeKind::COND: out << "_cond" << '\n'; break;
+            case AstNodeKind::CASE: out << "_typcase" << '\n'; break;
+            case AstNodeKind::NO_EXPR: out << "_no_expr" << '\n'; break;
+            case AstNodeKind::BLOCK: out << "_block" << '\n'; break;
+            case AstNodeKind::NEG: out << "_neg" << '\n'; break;
+            case AstNodeKind::NOT: out << "_comp" << '\n'; break;
+            case AstNodeKind::ISVOID: out << "_isvoid" << '\n'; break;
+            case AstNodeKind::PLUS: out << "_plus" << '\n'; break;
+            case AstNodeKind::SUB: out << "_sub" << '\n'; break;
+            case AstNodeKind::MUL: out << "_mul" << '\n'; break;
+            case AstNodeKind::DIV: out << "_divide" << '\n'; break;
+            case AstNodeKind::EQ: out << "_eq" << '\n'; break;
+            case AstNodeKind::LE: out << "_leq" << '\n'; break;
+            case AstNodeKind::LESS: out << "_lt" << '\n'; break;
+            case AstNodeKind::INT:
+                out << "_int" << '\n';
+                out.Indent(offset) << node.IntValue() << '\n';
+                break;
+            case AstNodeKind::BOOL:
+                out << "_bool" << '\n';
+                out.Indent(offset) << (node.BoolValue() ? '1' : '0') << '\n';
+                break;
+            case AstNodeKind::STRING:
+                out << "_string" << '\n';
+                out.Indent(offset) << '"' << node.Name() << '"' << '\n';
+                break;
+            case AstNodeKind::IDENTIFIER:
+                out << "_object" << '\n';
+                out.Indent(offset) << node.Name() << '\n';
+                break;
+        }
+    }
+
+    std::size_t Child(FlatAst::Node node, std::size_t idx, std::size_t offset) {
+        offset += 2;
+        if (idx == 1 && node.Kind() == AstNodeKind::DISPATCH) {
+            PrintDispatchHead(node, offset);
+        }
+        return offset;
+    }
+
+    void Leave(FlatAst::Node node, std::size_t offset) {
+        if (node.Kind() == AstNodeKind::BRANCH) {
+            return;
+        }
+        if (node.Kind() == AstNodeKind::DISPATCH) {
+            // no arguments: the object is the only child
+            if (!node.FirstChild().NextSibling()) {
+                PrintDispatchHead(node, offset + 2);
+            }
+            out.Indent(offset + 2) << ')' << '\n';
+        }
+        out.Indent(offset) << ": " << node.Type() << '\n';
+    }
+
+    // what stands between the object and the arguments
+    void PrintDispatchHead(FlatAst::Node node, std::size_t offset) {
+        if (!node.DeclaredType().empty()) {
+            out.Indent(offset) << node.DeclaredType() << '\n';
+        }
+        out.Indent(offset) << node.Name() << '\n';
+        out.Indent(offset) << '(' << '\n';
+    }
+};
+
+}  // namespace
+
+void PrintProgram(const FlatAst& ast) {
+    if (ast.Classes().empty()) {
+        return;
+    }
+    std::cout.flush();
+    OutputBuffer out(stdout);
+    FlatPrinter printer{out};
+    out << '#' << ast.Classes().front().lineOfCode << '\n';
+    out << "_program" << '\n';
+    for (const auto& cls : ast.Classes()) {
+        out.Indent(2) << '#' << cls.lineOfCode << '\n';
+        out.Indent(2) << "_class" << '\n';
+        out.Indent(4) << cls.id << '\n';
+        out.Indent(4) << cls.baseClass << '\n';
+        out.Indent(4) << '"' << cls.filename << '"' << '\n';
+        out.Indent(4) << '(' << '\n';
+        for (uint32_t i = cls.firstFeature; i < cls.firstFeature + cls.featureCount; ++i) {
+            const auto& feature = ast.GetFeature(i);
+            out.Indent(4) << '#' << feature.lineOfCode << '\n';
+            out.Indent(4) << (feature.isAttr ? "_attr" : "_method") << '\n';
+            out.Indent(6) << feature.id << '\n';
+            for (uint32_t j = feature.firstFormal; j < feature.firstFormal + feature.formalCount; ++j) {
+                const Formal& formal = ast.GetFormal(j);
+                out.Indent(6) << '#' << formal.lineOfCode << '\n';
+                out.Indent(6) << "_formal" << '\n';
+                out.Indent(8) << formal.id.value << '\n';
+                out.Indent(8) << formal.type.value << '\n';
+            }
+            out.Indent(6) << feature.type << '\n';
+            Walk(ast.Expr(feature), std::size_t{6}, printer);
+        }
+        out.Indent(4) << ')' << '\n';
+    }
+}
+
+void PrintProgram(const Program& program) {
+    PrintProgram(FlatAst(program));
+}
@@ -0,0 +1,210 @@
+#include "parser/parse_cache.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "lexer/parallel.h"
+#include "lexer/token_source.h"
+#include "parser/ast_stream.h"
+#include "parser/parser.h"
+#include "parser/visitor.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// What a class is identified by: its tokens, with lines relative to the
+// first one, and the version of the format its entry is stored in.
+std::string RangeKey(const Token* begin, const Token* end) {
+    std::string key(reinterpret_cast<const char*>(&AST_STREAM_VERSION), sizeof(AST_STREAM_VERSION));
+    const std::size_t base = begin->lineOfCode;
+    for (const Token* token = begin; token != end; ++token) {
+        const uint32_t fields[3] = {static_cast<uint32_t>(token->tokenType),
+                                    static_cast<uint32_t>(token->lineOfCode - base),
+                                    static_cast<uint32_t>(token->rawValue.view().size())};
+        key.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+        key += token->rawValue.view();
+    }
+    return key;
+}
+
+// two unrelated 64-bit hashes of the key, as 32 hex digits
+std::string EntryName(std::string_view key) {
+    uint64_t fnv = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        fnv = (fnv ^ c) * 1099511628211ull;
+    }
+    const uint64_t hash = std::hash<std::string_view>{}(key);
+    char name[40];
+    std::snprintf(name, sizeof(name), "%016llx%016llx.ast", static_cast<unsigned long long>(fnv),
+                  static_cast<unsigned long long>(hash));
+    return name;
+}
+
+bool ReadFile(const fs::path& path, std::string& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+// Written aside and renamed into place, so that a build running at the same
+// time never sees half an entry. A cache that can't be written is no error.
+void WriteFile(const fs::path& path, const std::string& data) {
+    fs::path temp = path;
+    temp += "." + std::to_string(::getpid()) + "." +
+            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::error_code ec;
+    {
+        std::ofstream out(temp, std::ios::binary);
+        if (!out.write(data.data(), data.size())) {
+            fs::remove(temp, ec);
+            return;
+        }
+    }
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+    }
+}
+
+// Moves the lines of a class parsed from line 1 to where it is, the way
+// ReadAst places a loaded entry: 0 and INVALID_LINE_OF_CODE stay as they are.
+class LineShifter {
+   public:
+    struct State {};
+
+    explicit LineShifter(std::size_t offset) : offset_(offset) {}
+
+    void Shift(Class& cls) {
+        Shift(cls.lineOfCode);
+        for (Feature* feature : cls.features) {
+            Shift(feature->lineOfCode);
+            for (Formal& formal : feature->arguments) {
+                Shift(formal.lineOfCode);
+            }
+            Walk(*feature->expr, State(), *this);
+        }
+    }
+
+    void Enter(Expression& expr, State&) {
+        Shift(expr.lineOfCode);
+        if (auto* case_ = std::get_if<Case>(&expr.data_)) {
+            for (BranchExpr* branch : case_->branches) {
+                Shift(branch->lineOfCode);
+            }
+        }
+    }
+    State Child(Expression&, std::size_t, State&) { return State(); }
+    void Leave(Expression&, State&) {}
+
+   private:
+    void Shift(std::size_t& lineOfCode) const {
+        if (lineOfCode != 0 && lineOfCode != INVALID_LINE_OF_CODE) {
+            lineOfCode += offset_;
+        }
+    }
+
+   private:
+    const std::size_t offset_;
+};
+
+}  // namespace
+
+bool ParseCache::Parse(const std::vector<Token>& tokens, std::size_t jobs, Program& program) {
+    hits_ = 0;
+    misses_ = 0;
+
+    // a class runs from its `class` keyword up to the next one or the end of its file
+    std::vector<ClassRange> ranges;
+    Symbol filename;
+    bool inClass = false;
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        const TokenType type = tokens[i].tokenType;
+        if (type == TokenType::PROGRAM || type == TokenType::CLASS) {
+            if (inClass) {
+                ranges.back().end = i;
+            }
+            inClass = type == TokenType::CLASS;
+            if (inClass) {
+                ranges.push_back(ClassRange{i, tokens.size(), filename});
+            } else {
+                filename = tokens[i].rawValue;
+            }
+        } else if (!inClass) {
+            return false;
+        }
+    }
+    if (ranges.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+
+    std::vector<Program> classes(ranges.size());
+    std::vector<char> parsed(ranges.size());
+    ParallelFor(ranges.size(), jobs, [&](std::size_t i) { parsed[i] = ParseClass(tokens, ranges[i], classes[i]); });
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        if (!parsed[i]) {
+            return false;
+        }
+    }
+    for (auto& cls : classes) {
+        program.classes.push_back(cls.classes.front());
+        program.arena.Merge(std::move(cls.arena));
+    }
+    return true;
+}
+
+bool ParseCache::ParseClass(const std::vector<Token>& tokens, const ClassRange& range, Program& program) {
+    const Token* begin = tokens.data() + range.begin;
+    const Token* end = tokens.data() + range.end;
+    const std::size_t lineOffset = begin->lineOfCode - 1;
+    const fs::path path = directory_ / EntryName(RangeKey(begin, end));
+
+    std::string data;
+    if (ReadFile(path, data) && ReadAst(data, program, lineOffset) && program.classes.size() == 1) {
+        ++hits_;
+    } else {
+        // parsed as if the class were the whole file, starting on line 1,
+        // which is how the entry stores it
+        std::vector<Token> relative;
+        relative.reserve(end - begin + 1);
+        relative.push_back(Token{TokenType::PROGRAM, range.filename, 0});
+        for (const Token* token = begin; token != end; ++token) {
+            relative.push_back(Token{token->tokenType, token->rawValue, token->lineOfCode - lineOffset});
+        }
+        VectorTokenSource source(relative);
+        // the errors are reported by the parse of the whole stream
+        std::ostringstream errors;
+        Parser parser(source, errors);
+        Program parsed = parser.parseProgram();
+        if (parser.errorCount() != 0 || parsed.classes.size() != 1) {
+            return false;
+        }
+
+        data.clear();
+        WriteAst(data, parsed);
+        WriteFile(path, data);
+        ++misses_;
+
+        LineShifter(lineOffset).Shift(*parsed.classes.front());
+        program = std::move(parsed);
+    }
+    // an entry is shared by equal classes of any file
+    program.classes.front()->filename = range.filename;
+    return true;
+}
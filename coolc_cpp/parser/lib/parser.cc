@@ -0,0 +1,547 @@
+#include "parser/parser.h"
+
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "lexer/token.h"
+#include "parser/syntax.h"
+
+namespace {
+
+// thrown by syntaxError(), caught where the grammar can recover
+struct SyntaxError {};
+// the input ended while skipping to a recovery point
+struct EndOfInput {};
+
+// the token as the reference parser names it in errors
+void PrintErrorToken(std::ostream& out, const Token& token) {
+    switch (token.tokenType) {
+        case TokenType::EOFILE:
+            out << "EOF";
+            break;
+        case TokenType::PUNCTUATION:
+            out << '\'' << token.rawValue << '\'';
+            break;
+        case TokenType::STR_CONST:
+            out << "STR_CONST =  \"" << token.rawValue << '"';
+            break;
+        case TokenType::INT_CONST:
+        case TokenType::BOOL_CONST:
+        case TokenType::TYPEID:
+        case TokenType::OBJECTID:
+        case TokenType::ERROR:
+            out << TokenTypeName(token.tokenType) << " = " << token.rawValue;
+            break;
+        default:
+            out << TokenTypeName(token.tokenType);
+            break;
+    }
+}
+
+}  // namespace
+
+Parser::Parser(TokenSource& source, std::ostream& errors) : next_(source), errors_(errors) {
+    while (next_->tokenType == TokenType::PROGRAM) {
+        filename_ = next_->rawValue;
+        ++next_;
+    }
+}
+
+void Parser::advance() {
+    if (quietTokens_ > 0) {
+        --quietTokens_;
+    }
+    lastLineOfCode_ = next_->lineOfCode;
+    ++next_;
+    while (next_->tokenType == TokenType::PROGRAM) {
+        filename_ = next_->rawValue;
+        ++next_;
+    }
+}
+
+void Parser::syntaxError() {
+    if (quietTokens_ == 0) {
+        const std::size_t lineOfCode =
+            next_->tokenType == TokenType::EOFILE ? lastLineOfCode_ : next_->lineOfCode;
+        errors_ << '"' << filename_ << "\", line " << lineOfCode << ": syntax error at or near ";
+        PrintErrorToken(errors_, *next_);
+        errors_ << '\n';
+    }
+    ++errorCount_;
+    quietTokens_ = 3;
+    throw SyntaxError{};
+}
+
+// Skipped tokens don't count towards quietTokens_, only the ones parsed
+// after the recovery point do.
+template <class Stop>
+void Parser::skipUntil(Stop stop) {
+    while (!stop()) {
+        if (next_->tokenType == TokenType::EOFILE) {
+            throw EndOfInput{};
+        }
+        lastLineOfCode_ = next_->lineOfCode;
+        ++next_;
+        while (next_->tokenType == TokenType::PROGRAM) {
+            filename_ = next_->rawValue;
+            ++next_;
+        }
+    }
+}
+
+Program Parser::parseProgram() {
+    return parseClasses(1);
+}
+
+Program Parser::parseFile() {
+    return parseClasses(0);
+}
+
+Program Parser::parseClasses(std::size_t minClasses) {
+    Program program;
+    try {
+        // a class that failed to parse still counts, as in `class: error ';'`
+        std::size_t classes = 0;
+        while (next_->tokenType != TokenType::EOFILE || classes < minClasses) {
+            ++classes;
+            try {
+                program.classes.push_back(parseClass());
+            } catch (const SyntaxError&) {
+                skipUntil([this] { return at(';'); });
+                advance();
+            }
+        }
+    } catch (const EndOfInput&) {
+    }
+    program.arena = std::move(arena_);
+    return program;
+}
+
+Class* Parser::parseClass() {
+    if (next_->tokenType != TokenType::CLASS) syntaxError();
+
+    Class* cls = arena_.make<Class>();
+    cls->lineOfCode = next_->lineOfCode;
+    cls->filename = filename_;
+
+    advance();
+
+    cls->id = parseType();
+    if (next_->tokenType == TokenType::INHERITS) {
+        advance();
+        cls->baseClass = parseType();
+    }
+    if (!at('{')) syntaxError();
+    advance();
+
+    while (true) {
+        try {
+            if (at('}')) {
+                // without its `;` the class isn't over: what follows is
+                // skipped like a broken feature
+                advance();
+                if (!at(';')) syntaxError();
+                advance();
+                return cls;
+            }
+            cls->features.push_back(parseFeature());
+            if (!at(';')) syntaxError();
+            advance();
+        } catch (const SyntaxError&) {
+            skipUntil([this] { return at(';'); });
+            advance();
+        }
+    }
+}
+
+Type Parser::parseType() {
+    if (next_->tokenType != TokenType::TYPEID) syntaxError();
+    Symbol value = next_->rawValue;
+    advance();
+    return Type{value};
+}
+
+IdentifierExpr Parser::parseIdentifier() {
+    if (next_->tokenType != TokenType::OBJECTID) syntaxError();
+    Symbol value = next_->rawValue;
+    advance();
+    return IdentifierExpr{value};
+}
+
+Feature* Parser::parseFeature() {
+    Feature* feature = arena_.make<Feature>();
+    feature->lineOfCode = next_->lineOfCode;
+    feature->id = parseIdentifier();
+    if (at('(')) {
+        feature->isAttr = false;
+        advance();
+        parseFormals(feature->arguments);
+        if (!at(':')) syntaxError();
+        advance();
+        feature->type = parseType();
+        if (!at('{')) syntaxError();
+        advance();
+        feature->expr = parseExpression();
+        if (!at('}')) syntaxError();
+        advance();
+    } else {
+        feature->isAttr = true;
+        if (!at(':')) syntaxError();
+        advance();
+        feature->type = parseType();
+        if (next_->tokenType != TokenType::ASSIGN) {
+            feature->expr = makeExpression(NoExpr{}, 0);
+        } else {
+            advance();
+            feature->expr = parseExpression();
+        }
+    }
+    return feature;
+}
+
+// `(a : A, b : B)`, past the opening parenthesis. An error anywhere in the
+// list resumes after the closing one, as `'(' error ')'` would.
+void Parser::parseFormals(std::vector<Formal>& formals) {
+    try {
+        if (!at(')')) {
+            while (true) {
+                parseFormal(formals);
+                if (at(')')) break;
+                if (!at(',')) syntaxError();
+                advance();
+            }
+        }
+    } catch (const SyntaxError&) {
+        skipUntil([this] { return at(')'); });
+    }
+    advance();
+}
+
+void Parser::parseFormal(std::vector<Formal>& formals) {
+    std::size_t lineOfCode = next_->lineOfCode;
+    auto id = parseIdentifier();
+    if (!at(':')) syntaxError();
+    advance();
+    auto type = parseType();
+    formals.push_back(Formal{id, type, lineOfCode});
+}
+
+// Precedence of the infix operators, from the COOL manual, section 11.1.
+// The prefix ones are listed for what their operand may contain: `not` takes
+// comparisons and everything tighter, `isvoid` and `~` only a primary
+// with its dispatches, and `<-` takes a whole expression.
+enum Precedence : int {
+    PREC_NONE = 0,
+    PREC_ASSIGN,
+    PREC_NOT,
+    PREC_COMPARE,  // <= < =, non-associative
+    PREC_ADD,      // + -
+    PREC_MUL,      // * /
+    PREC_ISVOID,
+    PREC_NEG,
+    PREC_DISPATCH,  // @ .
+};
+
+enum class BinaryOperator : uint8_t { NONE, PLUS, SUB, MUL, DIV, LESS, LE, EQ };
+
+struct OperatorInfo {
+    BinaryOperator op;
+    Precedence precedence;
+};
+
+OperatorInfo binaryOperator(const Token& token) {
+    switch (token.tokenType) {
+        case TokenType::LE:
+            return {BinaryOperator::LE, PREC_COMPARE};
+        case TokenType::PUNCTUATION:
+            switch (token.rawValue.view()[0]) {
+                case '+': return {BinaryOperator::PLUS, PREC_ADD};
+                case '-': return {BinaryOperator::SUB, PREC_ADD};
+                case '*': return {BinaryOperator::MUL, PREC_MUL};
+                case '/': return {BinaryOperator::DIV, PREC_MUL};
+                case '<': return {BinaryOperator::LESS, PREC_COMPARE};
+                case '=': return {BinaryOperator::EQ, PREC_COMPARE};
+                default: break;
+            }
+            break;
+        default:
+            break;
+    }
+    return {BinaryOperator::NONE, PREC_NONE};
+}
+
+// Precedence climbing: operators binding tighter than `limit` are taken
+// here, looser ones are left to the caller.
+Expression* Parser::parseExpression(int limit) {
+    Expression* lhs = parsePrefix();
+
+    while (true) {
+        const OperatorInfo info = binaryOperator(*next_);
+        if (info.precedence <= limit) {
+            return lhs;
+        }
+        const std::size_t lineOfCode = next_->lineOfCode;
+        advance();
+        // left associative: the right operand stops at the same precedence
+        Expression* rhs = parseExpression(info.precedence);
+        switch (info.op) {
+            case BinaryOperator::PLUS: lhs = makeExpression(PlusExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::SUB: lhs = makeExpression(SubExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::MUL: lhs = makeExpression(MulExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::DIV: lhs = makeExpression(DivExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::LESS: lhs = makeExpression(LessExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::LE: lhs = makeExpression(LeExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::EQ: lhs = makeExpression(EqExpr{lhs, rhs}, lineOfCode); break;
+            case BinaryOperator::NONE: break;
+        }
+        if (info.precedence == PREC_COMPARE && binaryOperator(*next_).precedence == PREC_COMPARE) {
+            syntaxError();
+        }
+    }
+}
+
+// prefix operators, or a primary followed by its dispatches
+Expression* Parser::parsePrefix() {
+    const std::size_t lineOfCode = next_->lineOfCode;
+    switch (next_->tokenType) {
+        case TokenType::NOT:
+            advance();
+            return makeExpression(NotExpr{parseExpression(PREC_NOT)}, lineOfCode);
+        case TokenType::ISVOID:
+            advance();
+            return makeExpression(IsVoidExpr{parseExpression(PREC_ISVOID)}, lineOfCode);
+        case TokenType::PUNCTUATION:
+            if (at('~')) {
+                advance();
+                return makeExpression(NegExpr{parseExpression(PREC_NEG)}, lineOfCode);
+            }
+            break;
+        default:
+            break;
+    }
+    return parseDispatch(parsePrimary());
+}
+
+Expression* Parser::parseBlock() {
+    std::size_t lineOfCode = next_->lineOfCode;
+    advance();
+    Expression* expr = makeExpression(BlockExpr{}, lineOfCode);
+    std::vector<Expression*> exprs;
+    do {
+        try {
+            exprs.push_back(parseExpression());
+            if (!at(';')) syntaxError();
+            advance();
+        } catch (const SyntaxError&) {
+            skipUntil([this] { return at(';'); });
+            advance();
+        }
+    } while (!at('}'));
+    advance();
+    std::get<BlockExpr>(expr->data_).exprs = arena_.makeSpan(exprs.begin(), exprs.end());
+    return expr;
+}
+
+// `let a : A, b : B in e` is the same tree as `let a : A in let b : B in e`;
+// the bindings are chained in a loop, however many of them there are.
+// An error in a binding or in the body resumes at the next binding or at
+// `in`, like the `error ',' ...` and `error IN expr` rules of the grammar.
+Expression* Parser::parseLet() {
+    Expression* first = nullptr;
+    LetExpr* last = nullptr;
+    bool binding = true;
+    while (true) {
+        try {
+            if (binding) {
+                Expression* expr = makeExpression(LetExpr{}, next_->lineOfCode);
+                auto& letExpr = std::get<LetExpr>(expr->data_);
+                (last == nullptr ? first : last->inExpr) = expr;
+                last = &letExpr;
+
+                letExpr.id = parseIdentifier();
+                if (!at(':')) syntaxError();
+                advance();
+                letExpr.type = parseType();
+                if (next_->tokenType == TokenType::ASSIGN) {
+                    advance();
+                    letExpr.expr = parseExpression();
+                } else {
+                    letExpr.expr = makeExpression(NoExpr{}, 0);
+                }
+                if (at(',')) {
+                    advance();
+                    continue;
+                }
+                if (next_->tokenType != TokenType::IN) syntaxError();
+            }
+            advance();
+            last->inExpr = parseExpression();
+            return first;
+        } catch (const SyntaxError&) {
+            skipUntil([this] { return at(',') || next_->tokenType == TokenType::IN; });
+            binding = at(',');
+            if (binding) {
+                advance();
+            }
+        }
+    }
+}
+
+std::span<Expression*> Parser::parseArguments() {
+    std::vector<Expression*> arguments;
+    if (!at(')')) {
+        while (true) {
+            arguments.push_back(parseExpression());
+            if (at(')')) break;
+            if (!at(',')) syntaxError();
+            advance();
+        }
+    }
+    advance();
+    return arena_.makeSpan(arguments.begin(), arguments.end());
+}
+
+// `obj@T.f(..).g(..)...`: every link takes the chain so far as its object,
+// so a chain of any length is parsed in a loop
+Expression* Parser::parseDispatch(Expression* obj) {
+    while (at('@') || at('.')) {
+        Expression* expr = makeExpression(DispatchExpr{}, INVALID_LINE_OF_CODE);
+        auto& dispatch = std::get<DispatchExpr>(expr->data_);
+        dispatch.obj = obj;
+        if (at('@')) {
+            advance();
+            dispatch.type = parseType();
+        }
+        if (!at('.')) syntaxError();
+        expr->lineOfCode = next_->lineOfCode;
+        advance();
+        dispatch.id = parseIdentifier();
+        if (!at('(')) syntaxError();
+        advance();
+        dispatch.arguments = parseArguments();
+        obj = expr;
+    }
+    return obj;
+}
+
+Expression* Parser::parsePrimary() {
+    const std::size_t lineOfCode = next_->lineOfCode;
+    switch (next_->tokenType) {
+        case TokenType::OBJECTID: {
+            auto objectExpr = parseIdentifier();
+            if (at('(')) {
+                advance();
+                Expression* expr = makeExpression(DispatchExpr{}, lineOfCode);
+                auto& dispatch = std::get<DispatchExpr>(expr->data_);
+                dispatch.obj = makeExpression(IdentifierExpr{"self"}, next_->lineOfCode);
+                dispatch.id = objectExpr;
+                dispatch.arguments = parseArguments();
+                return expr;
+            }
+            if (next_->tokenType == TokenType::ASSIGN) {
+                advance();
+                return makeExpression(AssignExpr{objectExpr, parseExpression()}, lineOfCode);
+            }
+            return makeExpression(objectExpr, lineOfCode);
+        }
+
+        case TokenType::LET:
+            advance();
+            return parseLet();
+
+        case TokenType::WHILE: {
+            advance();
+            auto predicatExpr = parseExpression();
+            if (next_->tokenType != TokenType::LOOP) syntaxError();
+            advance();
+            auto expr = parseExpression();
+            if (next_->tokenType != TokenType::POOL) syntaxError();
+            advance();
+            return makeExpression(WhileExpr{predicatExpr, expr}, lineOfCode);
+        }
+
+        case TokenType::CASE: {
+            advance();
+            Expression* expr = makeExpression(Case{}, lineOfCode);
+            auto& case_ = std::get<Case>(expr->data_);
+            case_.expr = parseExpression();
+            if (next_->tokenType != TokenType::OF) syntaxError();
+            advance();
+            std::vector<BranchExpr*> branches;
+            while (next_->tokenType != TokenType::ESAC) {
+                auto branch = arena_.make<BranchExpr>();
+                branch->lineOfCode = next_->lineOfCode;
+                branch->id = parseIdentifier();
+                if (!at(':')) syntaxError();
+                advance();
+                branch->type = parseType();
+                if (next_->tokenType != TokenType::DARROW) syntaxError();
+                advance();
+                branch->expr = parseExpression();
+                if (!at(';')) syntaxError();
+                advance();
+                branches.push_back(branch);
+            }
+            if (branches.empty()) syntaxError();
+            advance();
+            case_.branches = arena_.makeSpan(branches.begin(), branches.end());
+            return expr;
+        }
+
+        case TokenType::IF: {
+            advance();
+            auto predicat = parseExpression();
+            if (next_->tokenType != TokenType::THEN) syntaxError();
+            advance();
+            auto trueExpr = parseExpression();
+            if (next_->tokenType != TokenType::ELSE) syntaxError();
+            advance();
+            auto falseExpr = parseExpression();
+            if (next_->tokenType != TokenType::FI) syntaxError();
+            advance();
+            return makeExpression(CondExpr{predicat, trueExpr, falseExpr}, lineOfCode);
+        }
+
+        case TokenType::NEW:
+            advance();
+            return makeExpression(NewExpr{parseType()}, lineOfCode);
+
+        case TokenType::INT_CONST: {
+            int32_t value = std::stoi(next_->rawValue.str());
+            advance();
+            return makeExpression(IntExpr{value}, lineOfCode);
+        }
+
+        case TokenType::STR_CONST: {
+            Symbol value = next_->rawValue;
+            advance();
+            return makeExpression(StringExpr{value}, lineOfCode);
+        }
+
+        case TokenType::BOOL_CONST: {
+            bool value = next_->rawValue == "true";
+            advance();
+            return makeExpression(BoolExpr{value}, lineOfCode);
+        }
+
+        case TokenType::PUNCTUATION:
+            if (at('{')) {
+                return parseBlock();
+            }
+            if (at('(')) {
+                advance();
+                auto expr = parseExpression();
+                if (!at(')')) syntaxError();
+                advance();
+                return expr;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    syntaxError();
+}
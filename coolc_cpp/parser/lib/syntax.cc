@@ -1,281 +1,392 @@
 #include "parser/syntax.h"
 
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <type_traits>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
-///////////////// printer zone
-void PrintFormal(std::size_t offset, const Formal& formal) {
-    std::cout << std::string(offset, ' ') << "#" << formal.lineOfCode << std::endl;
-    std::cout << std::string(offset, ' ') << "_formal" << std::endl;
-    offset += 2;
-    std::cout << std::string(offset, ' ') << formal.id.value << std::endl;
-    std::cout << std::string(offset, ' ') << formal.type.value << std::endl;
-}
+#include "lexer/source_file.h"
+#include "parser/ast_stream.h"
+#include "parser/visitor.h"
+
+///////////////// reader zone
+namespace {
 
-void PrintFeature(std::size_t offset, const Feature& feature) {
-    if (!feature.isAttr) {
-        std::cout << std::string(offset, ' ') << "#" << feature.lineOfCode << std::endl;
-        std::cout << std::string(offset, ' ') << "_method" << std::endl;
-        offset += 2;
-        std::cout << std::string(offset, ' ') << feature.id.value << std::endl;
-        for (const auto& formal : feature.arguments) {
-            PrintFormal(offset, formal);
+// Single pass over the whole dump in memory. The format is line based and
+// the indentation carries no information the kinds don't, so every line is
+// taken with its leading blanks cut off.
+class AstReader {
+   public:
+    AstReader(std::string_view text, Arena& arena) : pos_(text.data()), end_(text.data() + text.size()), arena_(arena) {
+        Advance();
+    }
+
+    bool ReadProgram(std::vector<Class*>& classes) {
+        if (AtEnd()) {
+            return true;  // the reference parser prints nothing for no classes
         }
-        std::cout << std::string(offset, ' ') << feature.type.value << std::endl;
-        PrintExpression(offset, *(feature.expr));
-    } else {
-        std::cout << std::string(offset, ' ') << "#" << feature.lineOfCode << std::endl;
-        std::cout << std::string(offset, ' ') << "_attr" << std::endl;
-        offset += 2;
-        std::cout << std::string(offset, ' ') << feature.id.value << std::endl;
-        std::cout << std::string(offset, ' ') << feature.type.value << std::endl;
-        if (!std::is_same_v<decltype(*feature.expr), NoExpr>) {
-            PrintExpression(offset, *(feature.expr));
-        } else {
-            std::cout << std::string(offset, ' ') << "#" << 0 << std::endl;
-            std::cout << std::string(offset, ' ') << "_no_expr" << std::endl;
-            std::cout << std::string(offset, ' ') << ": _no_type" << std::endl;
+        ReadLineOfCode();
+        Expect("_program");
+        while (ok_ && !AtEnd()) {
+            classes.push_back(ReadClass());
         }
+        return ok_;
     }
-}
 
-void PrintClass(std::size_t offset, const Class& cls) {
-    std::cout << std::string(offset, ' ') << "#" << cls.lineOfCode << std::endl;
-    std::cout << std::string(offset, ' ') << "_class" << std::endl;
-    offset += 2;
-    std::cout << std::string(offset, ' ') << cls.id.value << std::endl;
-    std::cout << std::string(offset, ' ') << cls.baseClass.value << std::endl;
-    std::cout << std::string(offset, ' ') << '"' << cls.filename << '"' << std::endl;
-    std::cout << std::string(offset, ' ') << "(" << std::endl;
-    for (const auto& feature : cls.features) {
-        PrintFeature(offset, *feature);
+   private:
+    bool AtEnd() const { return line_.empty() && pos_ == end_; }
+
+    // the current line, without its indentation
+    std::string_view Peek() const { return line_; }
+
+    std::string_view Next() {
+        std::string_view line = line_;
+        Advance();
+        return line;
     }
-    std::cout << std::string(offset, ' ') << ")" << std::endl;
-}
 
-void PrintProgram(const Program& program) {
-    if (program.classes.empty()) {
-        return;
+    void Advance() {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\n')) {
+            ++pos_;
+        }
+        const char* eol = static_cast<const char*>(std::memchr(pos_, '\n', end_ - pos_));
+        if (eol == nullptr) {
+            eol = end_;
+        }
+        line_ = std::string_view(pos_, eol - pos_);
+        pos_ = eol;
     }
-    std::cout << "#" << program.classes.front()->lineOfCode << std::endl;
-    std::cout << "_program" << std::endl;
-    const std::size_t offset = 2;
-    for (const auto& cls : program.classes) {
-        PrintClass(offset, *cls);
+
+    void Fail() {
+        ok_ = false;
+        line_ = {};
+        pos_ = end_;
     }
-}
 
-void PrintBranchExpr(std::size_t offset, const BranchExpr& branch) {
-    std::cout << std::string(offset, ' ') << "#" << branch.lineOfCode << std::endl;
-    std::cout << std::string(offset, ' ') << "_branch" << std::endl;
-    offset += 2;
-    std::cout << std::string(offset, ' ') << branch.id.value << std::endl;
-    std::cout << std::string(offset, ' ') << branch.type.value << std::endl;
-    PrintExpression(offset, *branch.expr);
-}
+    void Expect(std::string_view expected) {
+        if (Next() != expected) {
+            Fail();
+        }
+    }
 
-void PrintExpression(std::size_t offset, const Expression& expression) {
-    std::cout << std::string(offset, ' ');
-    std::cout << "#" << expression.lineOfCode << std::endl;
-    std::cout << std::string(offset, ' ');
-    offset += 2;
+    bool NextIsNode() const { return !line_.empty() && line_[0] == '#'; }
 
-    std::visit(overloaded{
-                   [offset](const DispatchExpr& expr) {
-                       if (expr.type.value == "") {
-                           std::cout << "_dispatch" << std::endl;
-                       } else {
-                           std::cout << "_static_dispatch" << std::endl;
-                       }
-                       PrintExpression(offset, *expr.obj);
-                       if (expr.type.value != "") {
-                           std::cout << std::string(offset, ' ') << expr.type.value << std::endl;
-                       }
-                       std::cout << std::string(offset, ' ') << expr.id.value << std::endl;
-                       std::cout << std::string(offset, ' ') << "(" << std::endl;
-                       for (const auto& arg : expr.arguments) {
-                           PrintExpression(offset, *arg);
-                       }
-                       std::cout << std::string(offset, ' ') << ")" << std::endl;
-                   },
-                   [offset](const LetExpr& expr) {
-                       std::cout << "_let" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.id.value << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.type.value << std::endl;
-                       PrintExpression(offset, *expr.expr);
-                       PrintExpression(offset, *expr.inExpr);
-                   },
-                   [offset](const AssignExpr& expr) {
-                       std::cout << "_assign" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.id.value << std::endl;
-                       PrintExpression(offset, *expr.expr);
-                   },
-                   [offset](const WhileExpr& expr) {
-                       std::cout << "_loop" << std::endl;
-                       PrintExpression(offset, *expr.predicat);
-                       PrintExpression(offset, *expr.trueExpr);
-                   },
-                   [offset](const NewExpr& expr) {
-                       std::cout << "_new" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.type.value << std::endl;
-                   },
-                   [offset](const CondExpr& expr) {
-                       std::cout << "_cond" << std::endl;
-                       PrintExpression(offset, *expr.predicat);
-                       PrintExpression(offset, *expr.trueExpr);
-                       PrintExpression(offset, *expr.falseExpr);
-                   },
-                   [offset](const Case& expr) {
-                       std::cout << "_typcase" << std::endl;
-                       PrintExpression(offset, *expr.expr);
-                       for (const auto& branch : expr.branches) {
-                           PrintBranchExpr(offset, *branch);
-                       }
-                   },
-                   [offset](const NoExpr& expr) {
-                       std::cout << "_no_expr" << std::endl;
-                   },
-                   [offset](const BlockExpr& expr) {
-                       std::cout << "_block" << std::endl;
-                       for (const auto& exp : expr.exprs) {
-                           PrintExpression(offset, *exp);
-                       }
-                   },
-                   [offset](const NegExpr& expr) {
-                       std::cout << "_neg" << std::endl;
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const NotExpr& expr) {
-                       std::cout << "_comp" << std::endl;
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const IsVoidExpr& expr) {
-                       std::cout << "_isvoid" << std::endl;
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const PlusExpr& expr) {
-                       std::cout << "_plus" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const SubExpr& expr) {
-                       std::cout << "_sub" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const MulExpr& expr) {
-                       std::cout << "_mul" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const DivExpr& expr) {
-                       std::cout << "_divide" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const EqExpr& expr) {
-                       std::cout << "_eq" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const LeExpr& expr) {
-                       std::cout << "_leq" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const LessExpr& expr) {
-                       std::cout << "_lt" << std::endl;
-                       PrintExpression(offset, *expr.lhs);
-                       PrintExpression(offset, *expr.rhs);
-                   },
-                   [offset](const IntExpr& expr) {
-                       std::cout << "_int" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.value << std::endl;
-                   },
-                   [offset](const BoolExpr& expr) {
-                       std::cout << "_bool" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.value << std::endl;
-                   },
-                   [offset](const StringExpr& expr) {
-                       std::cout << "_string" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.value << std::endl;
-                   },
-                   [offset](const IdentifierExpr& expr) {
-                       std::cout << "_object" << std::endl;
-                       std::cout << std::string(offset, ' ') << expr.value << std::endl;
-                   },
-               },
-               expression.data_);
-    std::cout << std::string(offset - 2, ' ') << ": " << expression.type << std::endl;
-}
+    std::size_t ReadLineOfCode() {
+        std::string_view line = Next();
+        std::size_t value = 0;
+        if (line.size() < 2 || line[0] != '#' ||
+            std::from_chars(line.data() + 1, line.data() + line.size(), value).ptr != line.data() + line.size()) {
+            Fail();
+        }
+        return value;
+    }
 
-#include <optional>
+    Symbol ReadSymbol() {
+        std::string_view line = Next();
+        if (line.empty()) {
+            Fail();
+        }
+        return Symbol(line);
+    }
 
-// std::optional<Expression> ReadExpression() {
-//     //
-// }
+    // "value", still escaped the way the lexer printed it
+    Symbol ReadQuoted() {
+        std::string_view line = Next();
+        if (line.size() < 2 || line.front() != '"' || line.back() != '"') {
+            Fail();
+            return Symbol();
+        }
+        return Symbol(line.substr(1, line.size() - 2));
+    }
 
-// std::optional<Formal> ReadFormal() {
-//     // only for method
-//     return {};
-// }
+    Class* ReadClass() {
+        Class* cls = arena_.make<Class>();
+        cls->lineOfCode = ReadLineOfCode();
+        Expect("_class");
+        cls->id.value = ReadSymbol();
+        cls->baseClass.value = ReadSymbol();
+        cls->filename = ReadQuoted();
+        Expect("(");
+        while (ok_ && Peek() != ")") {
+            cls->features.push_back(ReadFeature());
+        }
+        Expect(")");
+        return cls;
+    }
 
-// // todo split feature into method/attr
-// std::optional<Feature> ReadFeature() {
-//     Feature feature;
-//     std::string str;
-//     std::cin >> str;
-//     feature.lineOfCode = std::stoi(str.substr(1, str.size() - 1));
-//     std::cin >> str;
-//     if (str == "_method") {
-//         std::cin >> feature.id.value;
-//         while (auto formal = ReadFormal()) {
-//             // program.classes.push_back(std::make_shared<Class>(cls.value()));
-//         }
-//         std::cin >> feature.type.value;
-//         // expr
-//     } else {
-//         std::cin >> feature.id.value;
-//         std::cin >> feature.type.value;
-//         // expr
-//     }
+    Feature* ReadFeature() {
+        Feature* feature = arena_.make<Feature>();
+        feature->lineOfCode = ReadLineOfCode();
+        std::string_view kind = Next();
+        if (kind == "_method") {
+            feature->isAttr = false;
+            feature->id.value = ReadSymbol();
+            // the return type comes before the body, so every node here is a formal
+            while (ok_ && NextIsNode()) {
+                Formal formal;
+                formal.lineOfCode = ReadLineOfCode();
+                Expect("_formal");
+                formal.id.value = ReadSymbol();
+                formal.type.value = ReadSymbol();
+                feature->arguments.push_back(formal);
+            }
+        } else if (kind == "_attr") {
+            feature->isAttr = true;
+            feature->id.value = ReadSymbol();
+        } else {
+            Fail();
+            return feature;
+        }
+        feature->type.value = ReadSymbol();
+        feature->expr = ReadExpression();
+        return feature;
+    }
+
+    template <class T>
+    Expression* Make(T&& node, std::size_t lineOfCode) {
+        return arena_.make<Expression>(std::forward<T>(node), lineOfCode);
+    }
+
+    // A node whose subexpressions are still being read. The dump is in
+    // prefix order, so the reader keeps these on a stack of its own rather
+    // than recursing once per level. The child lists of the open nodes are
+    // stacked the same way, from where each one starts, and go to the arena
+    // once the node is complete.
+    struct Frame {
+        Expression* expr;
+        std::size_t next = 0;
+        bool staticDispatch = false;
+        std::size_t children = 0;
+        std::size_t branches = 0;
+    };
+
+    Expression* ReadExpression() {
+        if (!ok_) {
+            return Make(NoExpr{}, 0);
+        }
+        const std::size_t depth = stack_.size();
+        ReadNode();
+        while (true) {
+            Frame& top = stack_.back();
+            if (ok_ && NextChild(top)) {
+                ReadNode();
+                continue;
+            }
+
+            std::string_view type = Next();
+            if (!type.starts_with(": ")) {
+                Fail();
+            } else {
+                top.expr->type = Symbol(type.substr(2));
+            }
+            Expression* expr = top.expr;
+            CloseLists(top);
+            stack_.pop_back();
+            if (stack_.size() == depth) {
+                return expr;
+            }
+            Attach(stack_.back(), expr);
+            ++stack_.back().next;
+        }
+    }
+
+    // reads the header of a node, up to its first subexpression, and
+    // pushes it
+    void ReadNode() {
+        const std::size_t lineOfCode = ReadLineOfCode();
+        const std::string_view kind = Next();
+
+        Frame frame{nullptr};
+        if (kind == "_object") {
+            frame.expr = Make(IdentifierExpr{ReadSymbol()}, lineOfCode);
+        } else if (kind == "_dispatch" || kind == "_static_dispatch") {
+            frame.expr = Make(DispatchExpr{}, lineOfCode);
+            frame.staticDispatch = kind == "_static_dispatch";
+        } else if (kind == "_int") {
+            std::string_view line = Next();
+            int32_t value = 0;
+            if (std::from_chars(line.data(), line.data() + line.size(), value).ptr != line.data() + line.size()) {
+                Fail();
+            }
+            frame.expr = Make(IntExpr{value}, lineOfCode);
+        } else if (kind == "_string") {
+            frame.expr = Make(StringExpr{ReadQuoted()}, lineOfCode);
+        } else if (kind == "_bool") {
+            frame.expr = Make(BoolExpr{Next() == "1"}, lineOfCode);
+        } else if (kind == "_no_expr") {
+            frame.expr = Make(NoExpr{}, lineOfCode);
+        } else if (kind == "_block") {
+            frame.expr = Make(BlockExpr{}, lineOfCode);
+        } else if (kind == "_assign") {
+            frame.expr = Make(AssignExpr{IdentifierExpr{ReadSymbol()}}, lineOfCode);
+        } else if (kind == "_plus") {
+            frame.expr = Make(PlusExpr{}, lineOfCode);
+        } else if (kind == "_sub") {
+            frame.expr = Make(SubExpr{}, lineOfCode);
+        } else if (kind == "_mul") {
+            frame.expr = Make(MulExpr{}, lineOfCode);
+        } else if (kind == "_divide") {
+            frame.expr = Make(DivExpr{}, lineOfCode);
+        } else if (kind == "_eq") {
+            frame.expr = Make(EqExpr{}, lineOfCode);
+        } else if (kind == "_lt") {
+            frame.expr = Make(LessExpr{}, lineOfCode);
+        } else if (kind == "_leq") {
+            frame.expr = Make(LeExpr{}, lineOfCode);
+        } else if (kind == "_neg") {
+            frame.expr = Make(NegExpr{}, lineOfCode);
+        } else if (kind == "_comp") {
+            frame.expr = Make(NotExpr{}, lineOfCode);
+        } else if (kind == "_isvoid") {
+            frame.expr = Make(IsVoidExpr{}, lineOfCode);
+        } else if (kind == "_new") {
+            frame.expr = Make(NewExpr{Type{ReadSymbol()}}, lineOfCode);
+        } else if (kind == "_cond") {
+            frame.expr = Make(CondExpr{}, lineOfCode);
+        } else if (kind == "_loop") {
+            frame.expr = Make(WhileExpr{}, lineOfCode);
+        } else if (kind == "_let") {
+            frame.expr = Make(LetExpr{}, lineOfCode);
+            auto& let = std::get<LetExpr>(frame.expr->data_);
+            let.id.value = ReadSymbol();
+            let.type.value = ReadSymbol();
+        } else if (kind == "_typcase") {
+            frame.expr = Make(Case{}, lineOfCode);
+        } else {
+            Fail();
+            frame.expr = Make(NoExpr{}, lineOfCode);
+        }
+        frame.children = children_.size();
+        frame.branches = branches_.size();
+        stack_.push_back(frame);
+    }
 
-//     return {};
-// }
+    // whether another subexpression of `frame` follows, reading whatever
+    // lines stand before it or close the node
+    bool NextChild(Frame& frame) {
+        Expression& expr = *frame.expr;
+        if (auto* dispatch = std::get_if<DispatchExpr>(&expr.data_)) {
+            if (frame.next == 0) {
+                return true;
+            }
+            if (frame.next == 1) {
+                if (frame.staticDispatch) {
+                    dispatch->type.value = ReadSymbol();
+                }
+                dispatch->id.value = ReadSymbol();
+                Expect("(");
+            }
+            if (Peek() != ")") {
+                return true;
+            }
+            Next();
+            return false;
+        }
+        if (std::holds_alternative<Case>(expr.data_)) {
+            if (frame.next == 0) {
+                return true;
+            }
+            if (!NextIsNode()) {
+                return false;
+            }
+            BranchExpr* branch = arena_.make<BranchExpr>();
+            branch->lineOfCode = ReadLineOfCode();
+            Expect("_branch");
+            branch->id.value = ReadSymbol();
+            branch->type.value = ReadSymbol();
+            branches_.push_back(branch);
+            return ok_;
+        }
+        if (std::holds_alternative<BlockExpr>(expr.data_)) {
+            return NextIsNode();
+        }
+        return frame.next < ChildCount(expr);
+    }
 
-std::optional<Class> ReadClass() {
-    Class cls;
-    std::string str;
-    if (!(std::cin >> str)) {
-        return {};
+    void Attach(Frame& frame, Expression* child) {
+        std::visit(
+            [&](auto& node) {
+                using T = std::decay_t<decltype(node)>;
+                if constexpr (std::is_base_of_v<UnaryExpr, T>) {
+                    node.rhs = child;
+                } else if constexpr (std::is_base_of_v<BinaryExpr, T>) {
+                    (frame.next == 0 ? node.lhs : node.rhs) = child;
+                } else if constexpr (std::is_same_v<T, AssignExpr>) {
+                    node.expr = child;
+                } else if constexpr (std::is_same_v<T, WhileExpr>) {
+                    (frame.next == 0 ? node.predicat : node.trueExpr) = child;
+                } else if constexpr (std::is_same_v<T, CondExpr>) {
+                    (frame.next == 0 ? node.predicat : frame.next == 1 ? node.trueExpr : node.falseExpr) = child;
+                } else if constexpr (std::is_same_v<T, LetExpr>) {
+                    (frame.next == 0 ? node.expr : node.inExpr) = child;
+                } else if constexpr (std::is_same_v<T, Case>) {
+                    (frame.next == 0 ? node.expr : branches_.back()->expr) = child;
+                } else if constexpr (std::is_same_v<T, BlockExpr>) {
+                    children_.push_back(child);
+                } else if constexpr (std::is_same_v<T, DispatchExpr>) {
+                    if (frame.next == 0) {
+                        node.obj = child;
+                    } else {
+                        children_.push_back(child);
+                    }
+                }
+            },
+            frame.expr->data_);
     }
-    cls.lineOfCode = std::stoi(str.substr(1, str.size() - 1));
-    std::cin >> str;
-    std::cin >> cls.id.value;
-    std::cin >> cls.baseClass.value;
-    std::cin >> cls.filename;
-    cls.filename = cls.filename.substr(1, cls.filename.size() - 2);
-    std::cin >> str; // "("
 
-    // while (auto feature = ReadFeature()) {
-        // program.classes.push_back(std::make_shared<Class>(cls.value()));
-    // }
+    // moves the lists of the complete node `frame` into the arena; a block
+    // without expressions or a case without branches is no dump
+    void CloseLists(const Frame& frame) {
+        const auto children = children_.begin() + static_cast<std::ptrdiff_t>(frame.children);
+        const auto branches = branches_.begin() + static_cast<std::ptrdiff_t>(frame.branches);
+        if (auto* block = std::get_if<BlockExpr>(&frame.expr->data_)) {
+            block->exprs = arena_.makeSpan(children, children_.end());
+            if (block->exprs.empty()) {
+                Fail();
+            }
+        } else if (auto* dispatch = std::get_if<DispatchExpr>(&frame.expr->data_)) {
+            dispatch->arguments = arena_.makeSpan(children, children_.end());
+        } else if (auto* case_ = std::get_if<Case>(&frame.expr->data_)) {
+            case_->branches = arena_.makeSpan(branches, branches_.end());
+            if (case_->branches.empty()) {
+                Fail();
+            }
+        }
+        children_.erase(children, children_.end());
+        branches_.erase(branches, branches_.end());
+    }
+
+   private:
+    const char* pos_;
+    const char* end_;
+    std::string_view line_;
+    bool ok_ = true;
+    std::vector<Frame> stack_;
+    std::vector<Expression*> children_;
+    std::vector<BranchExpr*> branches_;
 
-    std::cin >> str; // ")"
+    Arena& arena_;
+};
 
-    return cls;
+}  // namespace
+
+bool ReadProgram(std::string_view text, Program& program) {
+    AstReader reader(text, program.arena);
+    return reader.ReadProgram(program.classes);
 }
 
 Program ReadProgram() {
+    SourceFile input;
     Program program;
-    std::string _;
-    std::getline(std::cin, _);
-    std::getline(std::cin, _);
-
-    while (auto cls = ReadClass()) {
-        program.classes.push_back(std::make_shared<Class>(cls.value()));
+    // the binary stream is read where it lies: mapped, if stdin is a file
+    if (!input.Open("/dev/stdin") || !(ReadAst(input.View(), program) || ReadProgram(input.View(), program))) {
+        std::cerr << "ERROR: malformed AST on the standard input" << std::endl;
+        std::exit(EXIT_FAILURE);
     }
-
     return program;
 }
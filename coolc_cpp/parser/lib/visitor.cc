@@ -0,0 +1,59 @@
+#include "parser/visitor.h"
+
+#include <type_traits>
+#include <variant>
+
+// a generic lambda would beat `const UnaryExpr&` for NotExpr and the like,
+// so the base classes are told apart with if constexpr
+std::size_t ChildCount(const Expression& expr) {
+    return std::visit(
+        [](const auto& node) -> std::size_t {
+            using T = std::decay_t<decltype(node)>;
+            if constexpr (std::is_base_of_v<UnaryExpr, T> || std::is_same_v<T, AssignExpr>) {
+                return 1;
+            } else if constexpr (std::is_base_of_v<BinaryExpr, T> || std::is_same_v<T, WhileExpr> ||
+                                 std::is_same_v<T, LetExpr>) {
+                return 2;
+            } else if constexpr (std::is_same_v<T, CondExpr>) {
+                return 3;
+            } else if constexpr (std::is_same_v<T, Case>) {
+                return 1 + node.branches.size();
+            } else if constexpr (std::is_same_v<T, BlockExpr>) {
+                return node.exprs.size();
+            } else if constexpr (std::is_same_v<T, DispatchExpr>) {
+                return 1 + node.arguments.size();
+            } else {
+                return 0;
+            }
+        },
+        expr.data_);
+}
+
+Expression* Child(const Expression& expr, std::size_t idx) {
+    return std::visit(
+        [idx](const auto& node) -> Expression* {
+            using T = std::decay_t<decltype(node)>;
+            if constexpr (std::is_base_of_v<UnaryExpr, T>) {
+                return node.rhs;
+            } else if constexpr (std::is_base_of_v<BinaryExpr, T>) {
+                return idx == 0 ? node.lhs : node.rhs;
+            } else if constexpr (std::is_same_v<T, AssignExpr>) {
+                return node.expr;
+            } else if constexpr (std::is_same_v<T, WhileExpr>) {
+                return idx == 0 ? node.predicat : node.trueExpr;
+            } else if constexpr (std::is_same_v<T, CondExpr>) {
+                return idx == 0 ? node.predicat : idx == 1 ? node.trueExpr : node.falseExpr;
+            } else if constexpr (std::is_same_v<T, LetExpr>) {
+                return idx == 0 ? node.expr : node.inExpr;
+            } else if constexpr (std::is_same_v<T, Case>) {
+                return idx == 0 ? node.expr : node.branches[idx - 1]->expr;
+            } else if constexpr (std::is_same_v<T, BlockExpr>) {
+                return node.exprs[idx];
+            } else if constexpr (std::is_same_v<T, DispatchExpr>) {
+                return idx == 0 ? node.obj : node.arguments[idx - 1];
+            } else {
+                return nullptr;
+            }
+        },
+        expr.data_);
+}
@@ -1,26 +1,68 @@
+#include <cstdio>
+#include <string>
 #include <vector>
 
-#include "parser.h"
-#include "parser.h"
+#include "parser/ast_stream.h"
+#include "parser/parser.h"
 #include "lexer/token.h"
+#include "lexer/token_stream.h"
+
+std::vector<Token> parseBinaryInput() {
+    std::string data;
+    std::size_t size = 0;
+    while (true) {
+        data.resize(size + (1 << 20));
+        std::size_t n = std::fread(data.data() + size, 1, data.size() - size, stdin);
+        size += n;
+        if (n == 0) {
+            break;
+        }
+    }
+    data.resize(size);
 
-std::vector<Token> parseInput() {
     std::vector<Token> tokens;
-    for (Token token; std::cin >> token; ) {
-        tokens.push_back(token);
+    if (!ReadTokenStream(data, tokens)) {
+        std::cerr << "ERROR: malformed binary token stream" << std::endl;
+        std::exit(EXIT_FAILURE);
     }
-    tokens.push_back(Token{TokenType::EOFILE, "", 0});
     return tokens;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc > 1) {
-        std::cerr << "WARN: Usage: ./lexer [files ..] | ./parser" << std::endl;
+    // -b: the AST as a binary stream (see ast_stream.h), for semant only
+    const bool binary = argc > 1 && std::string(argv[1]) == "-b";
+    if (argc > 2 || (argc > 1 && !binary)) {
+        std::cerr << "WARN: Usage: ./lexer [-b] [files ..] | ./parser [-b]" << std::endl;
     }
 
-    auto tokens = parseInput();
-    auto program = Parser(tokens).parseProgram();
-    PrintProgram(program);
+    Program program;
+    std::size_t errors = 0;
+    // the text format always starts with '#', the binary one with its magic
+    if (std::cin.peek() == TOKEN_STREAM_MAGIC[0]) {
+        auto tokens = parseBinaryInput();
+        VectorTokenSource source(tokens);
+        Parser parser(source);
+        program = parser.parseProgram();
+        errors = parser.errorCount();
+    } else {
+        // tokens are parsed as they are read, never all held at once
+        StreamTokenSource source(std::cin);
+        Parser parser(source);
+        program = parser.parseProgram();
+        errors = parser.errorCount();
+    }
+    if (errors != 0) {
+        std::cerr << "Compilation halted due to lex and parse errors" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (binary) {
+        std::string data;
+        WriteAst(data, program);
+        std::fwrite(data.data(), 1, data.size(), stdout);
+        std::fflush(stdout);
+    } else {
+        PrintProgram(program);
+    }
 
     return EXIT_SUCCESS;
 }
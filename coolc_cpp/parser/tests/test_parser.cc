@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdio>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -32,19 +33,13 @@ void compare_parsers(const std::vector<std::string>& files) {
 
     const std::string files_str = imploded.str();
 
-    const std::string reference_cmd = lexer + " " + files_str + " | " + original_parser;
-    const std::string cmd = lexer + " " + files_str + " | " + parser;
+    // syntax errors go to stderr, and are compared as well
+    const std::string reference_cmd = lexer + " " + files_str + " | " + original_parser + " 2>&1";
+    const std::string cmd = lexer + " " + files_str + " | " + parser + " 2>&1";
 
     std::string reference_output = exec(reference_cmd.c_str());
     std::string output = exec(cmd.c_str());
 
-    // on correct input produce correct ouput
-    // my and referece error handling not equal
-    if (reference_output.empty()) {
-        ASSERT_TRUE(output.empty());
-        return;
-    }
-
     std::istringstream ref(reference_output);
     std::istringstream my(output);
     while (!ref.eof() || !my.eof()) {
@@ -66,6 +61,15 @@ TEST(EndToEnd, Multiple) {
     compare_parsers({example_stack});
 }
 
+TEST(EndToEnd, Examples) {
+    const std::string path = "../../../examples";
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        if (entry.path().extension() == ".cl") {
+            compare_parsers({entry.path()});
+        }
+    }
+}
+
 TEST(EndToEnd, EndToEnd) {
     const std::string path = "../../parser/tests/end-to-end";
     for (const auto& entry : std::filesystem::directory_iterator(path)) {
@@ -73,3 +77,35 @@ TEST(EndToEnd, EndToEnd) {
         compare_parsers({entry.path()});
     }
 }
+
+TEST(EndToEnd, SyntaxErrorsInSeveralFiles) {
+    // recovery carries on into the next file, which names its own errors
+    compare_parsers({"../../parser/tests/end-to-end/badfeatures.test",
+                     "../../../examples/arith.cl",
+                     "../../parser/tests/end-to-end/multipleclasses.test"});
+}
+
+TEST(EndToEnd, DeepExpressions) {
+    // left-deep trees far deeper than a small native stack allows one frame
+    // per level for; the reference stops indenting at 80 columns
+    const std::size_t depth = 3000;
+    std::string dispatch = "self", plus = "1";
+    for (std::size_t i = 0; i < depth; ++i) {
+        dispatch += ".f()";
+        plus += " + 1";
+    }
+    const std::string path = std::filesystem::temp_directory_path() / "deep_expressions.cl";
+    {
+        std::ofstream out(path);
+        out << "class Main {\n";
+        out << "  main() : Object { " << dispatch << " };\n";
+        out << "  f() : SELF_TYPE { self };\n";
+        out << "  g() : Int { " << plus << " };\n";
+        out << "};\n";
+    }
+
+    const std::string reference_cmd = "../../resource/bin/lexer " + path + " | ../../resource/bin/parser";
+    const std::string cmd = "ulimit -s 512; ./lexer " + path + " | ./parser";
+    ASSERT_EQ(exec(reference_cmd.c_str()), exec(cmd.c_str()));
+    std::filesystem::remove(path);
+}
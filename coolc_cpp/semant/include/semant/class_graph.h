@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "parser/syntax.h"
+
+// Inheritance graph with classes numbered in the order they were added:
+// names are looked up once, in a hash map, and everything after that is
+// integer ids. Link() resolves the base classes into a parent array and
+// builds the child lists, packed into one array.
+class ClassGraph {
+   public:
+    using ClassId = uint32_t;
+    static constexpr ClassId NO_CLASS = UINT32_MAX;
+
+    // the id of the new class, NO_CLASS if its name is taken
+    ClassId Add(const Class* cls);
+    // NO_CLASS if there is no such class
+    ClassId Find(Symbol name) const;
+    std::size_t Size() const { return classes_.size(); }
+    const Class& GetClass(ClassId id) const { return *classes_[id]; }
+
+    // Base classes that aren't in the graph leave NO_CLASS as the parent,
+    // and so does the class that names itself `root`.
+    void Link(ClassId root);
+    ClassId Parent(ClassId id) const { return parents_[id]; }
+    std::span<const ClassId> Children(ClassId id) const {
+        return {children_.data() + childBegin_[id], children_.data() + childBegin_[id + 1]};
+    }
+
+    // The classes below `root` by the child lists, found on an explicit
+    // stack. A class that isn't is in an inheritance cycle or inherits
+    // from one: following its parents never gets to `root`.
+    std::vector<char> ReachableFrom(ClassId root) const;
+
+   private:
+    std::vector<const Class*> classes_;
+    std::unordered_map<Symbol, ClassId> ids_;
+
+    std::vector<ClassId> parents_;
+    // children of `id` are children_[childBegin_[id] .. childBegin_[id + 1])
+    std::vector<uint32_t> childBegin_;
+    std::vector<ClassId> children_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "semant/class_graph.h"
+
+// Constant-time subtype and join queries over an acyclic ClassGraph, for
+// the type checker. Built once by a depth-first walk from the root:
+//   Conforms   A <= B iff B's pre/post interval holds A's;
+//   Join       the lowest common ancestor, the shallowest class between the
+//              first visits of A and B in the Euler tour, found in a
+//              sparse table of minima over the tour.
+// Every class of the graph must be below the root.
+class ClassHierarchy {
+   public:
+    using ClassId = ClassGraph::ClassId;
+
+    ClassHierarchy() = default;
+    ClassHierarchy(const ClassGraph& graph, ClassId root);
+
+    bool Conforms(ClassId lhs, ClassId rhs) const {
+        return pre_[rhs] <= pre_[lhs] && post_[lhs] <= post_[rhs];
+    }
+    // the least class both conform to
+    ClassId Join(ClassId lhs, ClassId rhs) const;
+    std::size_t Depth(ClassId id) const { return depth_[id]; }
+    // every class, parents before children and siblings in id order
+    const std::vector<ClassId>& PreOrder() const { return preOrder_; }
+
+   private:
+    ClassId Shallower(ClassId lhs, ClassId rhs) const { return depth_[lhs] <= depth_[rhs] ? lhs : rhs; }
+
+   private:
+    std::vector<uint32_t> pre_;
+    std::vector<uint32_t> post_;
+    std::vector<uint32_t> depth_;
+    std::vector<ClassId> preOrder_;
+    // where each class first shows up in the tour
+    std::vector<uint32_t> firstVisit_;
+    // level k holds, for every i, the shallowest class of tour[i .. i + 2^k)
+    std::vector<std::vector<ClassId>> sparse_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "parser/syntax.h"
+#include "semant/class_graph.h"
+
+// The dispatch table and the attributes of every class, for dispatch in the
+// type checker and for code generation. A class starts from its parent's
+// tables: a method keeps the slot of the method it redefines, new methods
+// and attributes go at the end, in the order they are defined.
+//
+// All tables live in two flat arrays and a class owns a range of each. A
+// class that redefines nothing in its parent's table, and whose parent's
+// range is still the last one, extends that range in place rather than
+// copying it: a chain of classes shares one table. Slots and offsets of
+// every (class, name) pair are in hash maps, so a lookup never walks the
+// chain of parents.
+class ClassLayout {
+   public:
+    using ClassId = ClassGraph::ClassId;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    // a slot of a dispatch table, or an attribute
+    struct Entry {
+        const Feature* feature;
+        // the class that defines it
+        ClassId owner;
+    };
+
+    ClassLayout() = default;
+    explicit ClassLayout(std::size_t classCount) : methods_(classCount), attributes_(classCount) {}
+
+    // Lays out class `id` with its own methods and attributes in definition
+    // order; parents go first.
+    void Add(ClassId id, ClassId parent, std::span<const Feature* const> methods,
+             std::span<const Feature* const> attributes);
+
+    // NO_SLOT if class `id` has no such method or attribute
+    uint32_t MethodSlot(ClassId id, Symbol name) const { return methods_.Find(id, name); }
+    uint32_t AttributeOffset(ClassId id, Symbol name) const { return attributes_.Find(id, name); }
+
+    // the implementation class `id` dispatches `name` to, nullptr if none
+    const Entry* FindMethod(ClassId id, Symbol name) const { return methods_.FindEntry(id, name); }
+    const Entry* FindAttribute(ClassId id, Symbol name) const { return attributes_.FindEntry(id, name); }
+
+    std::span<const Entry> Methods(ClassId id) const { return methods_.Of(id); }
+    std::span<const Entry> Attributes(ClassId id) const { return attributes_.Of(id); }
+
+    // number of entries stored for all classes together, to see the sharing
+    std::size_t MethodStorage() const { return methods_.entries.size(); }
+    std::size_t AttributeStorage() const { return attributes_.entries.size(); }
+
+   private:
+    struct Tables {
+        struct Range {
+            uint32_t begin = 0;
+            uint32_t size = 0;
+        };
+
+        Tables() = default;
+        explicit Tables(std::size_t classCount) : ranges(classCount) {}
+
+        void Add(ClassId id, ClassId parent, std::span<const Feature* const> features);
+        uint32_t Find(ClassId id, Symbol name) const;
+        const Entry* FindEntry(ClassId id, Symbol name) const;
+        std::span<const Entry> Of(ClassId id) const {
+            return std::span<const Entry>(entries).subspan(ranges[id].begin, ranges[id].size);
+        }
+        static uint64_t Key(ClassId id, Symbol name) { return uint64_t{id} << 32 | name.id(); }
+
+        std::vector<Entry> entries;
+        std::vector<Range> ranges;
+        // (class, name) -> index in the class's range
+        std::unordered_map<uint64_t, uint32_t> slots;
+    };
+
+   private:
+    Tables methods_;
+    Tables attributes_;
+};
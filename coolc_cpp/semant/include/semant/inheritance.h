@@ -0,0 +1,43 @@
+#pragma once
+
+#include "parser/syntax.h"
+#include "semant/class_graph.h"
+#include "semant/class_hierarchy.h"
+
+// Checks the class hierarchy the way the reference semant does, errors in
+// its order: redefinitions in program order, then bad base classes and then
+// inheritance cycles from the last class up. Each stage runs only if the
+// ones before it found nothing, except that redefined classes are dropped
+// and their base classes checked anyway. The basic classes are installed
+// with their features, for the type checker.
+struct InheritanceAnalyzer {
+   private:
+    ClassGraph graph;
+    // built once the graph is known to be a tree
+    ClassHierarchy hierarchy;
+    const Program& program;
+    // basic classes
+    Arena arena;
+    ClassGraph::ClassId object = ClassGraph::NO_CLASS;
+    // the classes of the program get ids from here on
+    ClassGraph::ClassId firstClass = 0;
+
+   public:
+    InheritanceAnalyzer(const Program& program) : program(program) {}
+
+    bool Initialize();
+    bool hasBadBaseClass() const;
+    bool hasCycle();
+
+    bool checkCorrectness();
+
+    const ClassGraph& Graph() const { return graph; }
+    const ClassHierarchy& Hierarchy() const { return hierarchy; }
+    ClassGraph::ClassId ObjectClass() const { return object; }
+    ClassGraph::ClassId FirstClass() const { return firstClass; }
+
+   private:
+    Class* makeBasicClass(Symbol id, Symbol baseClass);
+    void addMethod(Class* cls, Symbol id, Symbol type, std::vector<Formal> arguments = {});
+    void addAttribute(Class* cls, Symbol id, Symbol type);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "lexer/symbol.h"
+
+// The object identifiers bound by formals, lets and case branches, with
+// their declared types, or where code generation keeps them. Bindings live
+// on one stack; each one remembers the binding of the same name it shadows,
+// and a hash map keyed by symbol id points at the innermost binding of every
+// name. Bind, Unbind and Find are all O(1), however deep the nesting.
+template <class Value = Symbol>
+class Scope {
+   public:
+    void Bind(Symbol id, Value value) {
+        uint32_t& innermost = innermost_.try_emplace(id.id(), NO_BINDING).first->second;
+        bindings_.push_back(Binding{id, value, innermost});
+        innermost = bindings_.size() - 1;
+    }
+
+    // drops the latest binding
+    void Unbind() {
+        const Binding& binding = bindings_.back();
+        if (binding.shadowed == NO_BINDING) {
+            innermost_.erase(binding.id.id());
+        } else {
+            innermost_[binding.id.id()] = binding.shadowed;
+        }
+        bindings_.pop_back();
+    }
+
+    // the value of the innermost binding of `id`, nullptr if unbound
+    const Value* Find(const Symbol& id) const {
+        const auto it = innermost_.find(id.id());
+        return it == innermost_.end() ? nullptr : &bindings_[it->second].value;
+    }
+
+    std::size_t Depth() const { return bindings_.size(); }
+
+    void Clear() {
+        bindings_.clear();
+        innermost_.clear();
+    }
+
+   private:
+    static constexpr uint32_t NO_BINDING = UINT32_MAX;
+
+    struct Binding {
+        Symbol id;
+        Value value;
+        uint32_t shadowed;
+    };
+
+   private:
+    std::vector<Binding> bindings_;
+    std::unordered_map<uint32_t, uint32_t> innermost_;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "parser/syntax.h"
+#include "semant/class_layout.h"
+#include "semant/inheritance.h"
+
+// Types every expression of a program whose class hierarchy
+// InheritanceAnalyzer accepted, filling in Expression::type, with the
+// errors and error order of the reference semant:
+//   1. the feature tables of every class, parents first: features defined
+//      twice in a class, attributes redefined and methods redefined with
+//      another signature than the inherited one;
+//      the classes are laid out from the tables then (ClassLayout), and
+//      names resolve in the layout from here on;
+//   2. the Main class and its main method;
+//   3. the features of every class of the program, parents first.
+// Steps 1 and 3 run on `jobs` threads, a class at a time: the tables of a
+// class hold only its own features, filled before anything reads them, and
+// each class writes the types of its own nodes and its errors to a buffer
+// of its own, printed in class order once all are done.
+class TypeChecker {
+   public:
+    TypeChecker(const InheritanceAnalyzer& inheritance, std::size_t jobs = 1);
+
+    // false if there were errors, which are on std::cerr by then
+    bool Check();
+
+    // the features of class `id` itself, by name
+    using FeatureTable = std::unordered_map<Symbol, const Feature*>;
+    struct ClassTables {
+        FeatureTable methods;
+        FeatureTable attributes;
+    };
+
+    // the nearest definition in `id` or its ancestors, nullptr if none;
+    // looked up in the layout, once step 1 is done
+    const Feature* FindMethod(ClassGraph::ClassId id, Symbol name) const;
+    const Feature* FindAttribute(ClassGraph::ClassId id, Symbol name) const;
+    // dispatch tables and attributes of the classes without errors in step 1
+    const ClassLayout& Layout() const { return layout_; }
+
+    // SELF_TYPE stands for SELF_TYPE of class `self`. A class that isn't
+    // defined conforms both ways, and the other type is the join: its
+    // error has been reported where it was named.
+    bool Conforms(Symbol lhs, Symbol rhs, ClassGraph::ClassId self) const;
+    Symbol Join(Symbol lhs, Symbol rhs, ClassGraph::ClassId self) const;
+    // a class of the graph or SELF_TYPE
+    bool IsDefined(Symbol type) const;
+
+    const ClassGraph& Graph() const { return graph_; }
+
+   private:
+    void BuildTables(ClassGraph::ClassId id);
+    // errors of the features of `id` against its tables and its ancestors';
+    // `inherited` gets the attributes the class defines again
+    void CheckTables(ClassGraph::ClassId id, std::ostream& errors, std::vector<Symbol>& inherited) const;
+    // the tables of `id` and its ancestors, before there is a layout
+    const Feature* FindInTables(ClassGraph::ClassId id, Symbol name, FeatureTable ClassTables::*table) const;
+    void LayOut(ClassGraph::ClassId id);
+    bool CheckMain() const;
+    // prints what a class checked on another thread reported, true if nothing
+    static bool Flush(const std::ostringstream& errors);
+
+   private:
+    const ClassGraph& graph_;
+    const ClassHierarchy& hierarchy_;
+    ClassGraph::ClassId firstClass_;
+    std::size_t jobs_;
+    std::vector<ClassTables> tables_;
+    ClassLayout layout_;
+};
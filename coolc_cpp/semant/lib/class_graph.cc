@@ -0,0 +1,57 @@
+#include "semant/class_graph.h"
+
+ClassGraph::ClassId ClassGraph::Add(const Class* cls) {
+    const auto [it, inserted] = ids_.emplace(cls->id.value, classes_.size());
+    if (!inserted) {
+        return NO_CLASS;
+    }
+    classes_.push_back(cls);
+    return it->second;
+}
+
+ClassGraph::ClassId ClassGraph::Find(Symbol name) const {
+    const auto it = ids_.find(name);
+    return it == ids_.end() ? NO_CLASS : it->second;
+}
+
+void ClassGraph::Link(ClassId root) {
+    const std::size_t count = classes_.size();
+    parents_.assign(count, NO_CLASS);
+    childBegin_.assign(count + 1, 0);
+    for (ClassId id = 0; id < count; ++id) {
+        if (id != root) {
+            parents_[id] = Find(classes_[id]->baseClass.value);
+        }
+        if (parents_[id] != NO_CLASS) {
+            ++childBegin_[parents_[id] + 1];
+        }
+    }
+
+    // counts to offsets, then every child into its parent's slice, in order
+    for (std::size_t id = 0; id < count; ++id) {
+        childBegin_[id + 1] += childBegin_[id];
+    }
+    children_.resize(childBegin_[count]);
+    std::vector<uint32_t> next(childBegin_.begin(), childBegin_.end() - 1);
+    for (ClassId id = 0; id < count; ++id) {
+        if (parents_[id] != NO_CLASS) {
+            children_[next[parents_[id]]++] = id;
+        }
+    }
+}
+
+std::vector<char> ClassGraph::ReachableFrom(ClassId root) const {
+    std::vector<char> reached(classes_.size());
+    std::vector<ClassId> stack = {root};
+    reached[root] = 1;
+    while (!stack.empty()) {
+        const ClassId id = stack.back();
+        stack.pop_back();
+        for (const ClassId child : Children(id)) {
+            // a class has one parent, so it is reached at most once
+            reached[child] = 1;
+            stack.push_back(child);
+        }
+    }
+    return reached;
+}
@@ -0,0 +1,76 @@
+#include "semant/class_hierarchy.h"
+
+#include <bit>
+#include <utility>
+
+ClassHierarchy::ClassHierarchy(const ClassGraph& graph, ClassId root) {
+    const std::size_t count = graph.Size();
+    pre_.assign(count, 0);
+    post_.assign(count, 0);
+    depth_.assign(count, 0);
+    firstVisit_.assign(count, 0);
+
+    // a class goes on the tour when it is entered and again after each child
+    std::vector<ClassId> tour;
+    tour.reserve(2 * count);
+    struct Frame {
+        ClassId id;
+        std::size_t next;
+    };
+    std::vector<Frame> stack = {{root, 0}};
+    uint32_t preCounter = 0;
+    uint32_t postCounter = 0;
+    preOrder_.reserve(count);
+    preOrder_.push_back(root);
+    pre_[root] = preCounter++;
+    firstVisit_[root] = tour.size();
+    tour.push_back(root);
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        const auto children = graph.Children(top.id);
+        if (top.next == children.size()) {
+            post_[top.id] = postCounter++;
+            stack.pop_back();
+            if (!stack.empty()) {
+                tour.push_back(stack.back().id);
+            }
+            continue;
+        }
+        const ClassId child = children[top.next++];
+        depth_[child] = depth_[top.id] + 1;
+        pre_[child] = preCounter++;
+        preOrder_.push_back(child);
+        firstVisit_[child] = tour.size();
+        tour.push_back(child);
+        // `top` dangles once the stack grows
+        stack.push_back(Frame{child, 0});
+    }
+
+    sparse_.push_back(std::move(tour));
+    for (std::size_t width = 2; width <= sparse_.front().size(); width *= 2) {
+        const std::vector<ClassId>& prev = sparse_.back();
+        std::vector<ClassId> level(prev.size() - width / 2);
+        for (std::size_t i = 0; i < level.size(); ++i) {
+            level[i] = Shallower(prev[i], prev[i + width / 2]);
+        }
+        sparse_.push_back(std::move(level));
+    }
+}
+
+ClassHierarchy::ClassId ClassHierarchy::Join(ClassId lhs, ClassId rhs) const {
+    if (Conforms(lhs, rhs)) {
+        return rhs;
+    }
+    if (Conforms(rhs, lhs)) {
+        return lhs;
+    }
+    std::size_t begin = firstVisit_[lhs];
+    std::size_t end = firstVisit_[rhs];
+    if (begin > end) {
+        std::swap(begin, end);
+    }
+    // two overlapping power-of-two windows cover [begin, end]
+    const std::size_t level = std::bit_width(end - begin + 1) - 1;
+    const std::vector<ClassId>& row = sparse_[level];
+    return Shallower(row[begin], row[end + 1 - (std::size_t{1} << level)]);
+}
@@ -0,0 +1,52 @@
+#include "semant/class_layout.h"
+
+void ClassLayout::Add(ClassId id, ClassId parent, std::span<const Feature* const> methods,
+                      std::span<const Feature* const> attributes) {
+    methods_.Add(id, parent, methods);
+    attributes_.Add(id, parent, attributes);
+}
+
+void ClassLayout::Tables::Add(ClassId id, ClassId parent, std::span<const Feature* const> features) {
+    const Range inherited = parent != ClassGraph::NO_CLASS ? ranges[parent] : Range{};
+    bool redefines = false;
+    for (const Feature* feature : features) {
+        redefines = redefines || (parent != ClassGraph::NO_CLASS && Find(parent, feature->id.value) != NO_SLOT);
+    }
+
+    Range& range = ranges[id];
+    if (!redefines && inherited.begin + inherited.size == entries.size()) {
+        // nobody has put anything after the parent's table yet
+        range.begin = inherited.begin;
+    } else {
+        range.begin = entries.size();
+        for (uint32_t i = 0; i < inherited.size; ++i) {
+            const Entry entry = entries[inherited.begin + i];
+            entries.push_back(entry);
+        }
+    }
+    range.size = inherited.size;
+    for (uint32_t i = 0; i < inherited.size; ++i) {
+        slots.emplace(Key(id, entries[range.begin + i].feature->id.value), i);
+    }
+
+    for (const Feature* feature : features) {
+        const Symbol& name = feature->id.value;
+        const uint32_t slot = parent != ClassGraph::NO_CLASS ? Find(parent, name) : NO_SLOT;
+        if (slot != NO_SLOT) {
+            entries[range.begin + slot] = Entry{feature, id};
+        } else {
+            slots.emplace(Key(id, name), range.size++);
+            entries.push_back(Entry{feature, id});
+        }
+    }
+}
+
+uint32_t ClassLayout::Tables::Find(ClassId id, Symbol name) const {
+    const auto it = slots.find(Key(id, name));
+    return it == slots.end() ? NO_SLOT : it->second;
+}
+
+const ClassLayout::Entry* ClassLayout::Tables::FindEntry(ClassId id, Symbol name) const {
+    const uint32_t slot = Find(id, name);
+    return slot == NO_SLOT ? nullptr : &entries[ranges[id].begin + slot];
+}
@@ -0,0 +1,129 @@
+#include "semant/inheritance.h"
+
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// classes the program may neither define nor, but for Object and IO, inherit
+const std::unordered_set<Symbol>& BasicClasses() {
+    static const std::unordered_set<Symbol> classes = {"Object", "IO", "Int", "String", "Bool", "SELF_TYPE"};
+    return classes;
+}
+
+const std::unordered_set<Symbol>& FinalClasses() {
+    static const std::unordered_set<Symbol> classes = {"Int", "String", "Bool", "SELF_TYPE"};
+    return classes;
+}
+
+std::ostream& Error(const Class& cls) {
+    return std::cerr << cls.filename << ":" << cls.lineOfCode << ": ";
+}
+
+}  // namespace
+
+Class* InheritanceAnalyzer::makeBasicClass(Symbol id, Symbol baseClass) {
+    Class* cls = arena.make<Class>(
+        Class{.id = {id}, .baseClass = {baseClass}, .features = {}, .filename = "<basic class>", .lineOfCode = 0});
+    graph.Add(cls);
+    return cls;
+}
+
+void InheritanceAnalyzer::addMethod(Class* cls, Symbol id, Symbol type, std::vector<Formal> arguments) {
+    for (auto& formal : arguments) {
+        formal.lineOfCode = 0;
+    }
+    Feature* feature = arena.make<Feature>(Feature{id, std::move(arguments), type, nullptr, 0, false});
+    feature->expr = arena.make<Expression>(NoExpr{}, 0);
+    cls->features.push_back(feature);
+}
+
+void InheritanceAnalyzer::addAttribute(Class* cls, Symbol id, Symbol type) {
+    Feature* feature = arena.make<Feature>(Feature{id, {}, type, nullptr, 0, true});
+    feature->expr = arena.make<Expression>(NoExpr{}, 0);
+    cls->features.push_back(feature);
+}
+
+// what the runtime provides, with the formal names of the reference
+bool InheritanceAnalyzer::Initialize() {
+    Class* objectClass = makeBasicClass("Object", "_no_class");
+    object = graph.Find("Object");
+    addMethod(objectClass, "abort", "Object");
+    addMethod(objectClass, "type_name", "String");
+    addMethod(objectClass, "copy", "SELF_TYPE");
+
+    Class* io = makeBasicClass("IO", "Object");
+    addMethod(io, "out_string", "SELF_TYPE", {Formal{"arg", "String"}});
+    addMethod(io, "out_int", "SELF_TYPE", {Formal{"arg", "Int"}});
+    addMethod(io, "in_string", "String");
+    addMethod(io, "in_int", "Int");
+
+    // the values themselves live in slots of no class
+    addAttribute(makeBasicClass("Int", "Object"), "_val", "_prim_slot");
+    addAttribute(makeBasicClass("Bool", "Object"), "_val", "_prim_slot");
+
+    Class* string = makeBasicClass("String", "Object");
+    addAttribute(string, "_val", "Int");
+    addAttribute(string, "_str_field", "_prim_slot");
+    addMethod(string, "length", "Int");
+    addMethod(string, "concat", "String", {Formal{"arg", "String"}});
+    addMethod(string, "substr", "String", {Formal{"arg", "Int"}, Formal{"arg2", "Int"}});
+    firstClass = graph.Size();
+
+    bool status = true;
+    for (const Class* cls : program.classes) {
+        const Symbol& id = cls->id.value;
+        if (BasicClasses().count(id)) {
+            Error(*cls) << "Redefinition of basic class " << id << "." << std::endl;
+            status = false;
+        } else if (graph.Add(cls) == ClassGraph::NO_CLASS) {
+            Error(*cls) << "Class " << id << " was previously defined." << std::endl;
+            status = false;
+        }
+    }
+    return status;
+}
+
+bool InheritanceAnalyzer::hasBadBaseClass() const {
+    bool status = false;
+    for (ClassGraph::ClassId id = graph.Size(); id-- > firstClass;) {
+        const Class& cls = graph.GetClass(id);
+        const Symbol& base = cls.baseClass.value;
+        if (FinalClasses().count(base)) {
+            Error(cls) << "Class " << cls.id.value << " cannot inherit class " << base << "." << std::endl;
+            status = true;
+        } else if (graph.Find(base) == ClassGraph::NO_CLASS) {
+            Error(cls) << "Class " << cls.id.value << " inherits from an undefined class " << base << "." << std::endl;
+            status = true;
+        }
+    }
+    return status;
+}
+
+// Every base class is defined by now, so a class Object doesn't reach is in
+// a cycle or below one. The graph is linked here, once it can be.
+bool InheritanceAnalyzer::hasCycle() {
+    graph.Link(object);
+    const std::vector<char> reached = graph.ReachableFrom(object);
+    bool status = false;
+    for (ClassGraph::ClassId id = graph.Size(); id-- > firstClass;) {
+        if (!reached[id]) {
+            const Class& cls = graph.GetClass(id);
+            Error(cls) << "Class " << cls.id.value << ", or an ancestor of " << cls.id.value
+                       << ", is involved in an inheritance cycle." << std::endl;
+            status = true;
+        }
+    }
+    return status;
+}
+
+bool InheritanceAnalyzer::checkCorrectness() {
+    bool isCorrect = Initialize();
+    isCorrect = !hasBadBaseClass() && isCorrect;
+    if (!isCorrect) return false;
+    if (hasCycle()) return false;
+    hierarchy = ClassHierarchy(graph, object);
+
+    return true;
+}
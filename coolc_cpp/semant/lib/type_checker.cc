@@ -0,0 +1,555 @@
+#include "semant/type_checker.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "lexer/parallel.h"
+#include "parser/visitor.h"
+#include "semant/scope.h"
+
+namespace {
+
+using ClassId = ClassGraph::ClassId;
+
+// interned once, the checks of classes running in parallel don't touch the
+// symbol table
+struct Names {
+    Symbol selfType = "SELF_TYPE";
+    Symbol self = "self";
+    Symbol object = "Object";
+    Symbol integer = "Int";
+    Symbol boolean = "Bool";
+    Symbol string = "String";
+    Symbol noType = Symbol::NoType();
+    Symbol main = "Main";
+    Symbol mainMethod = "main";
+};
+
+const Names& names() {
+    static const Names names;
+    return names;
+}
+
+// Checks the features of one class. Formals, lets and case branches bind
+// names in a Scope; what isn't bound there is self or an attribute.
+class ClassChecker {
+   public:
+    // per node of the walk: the branch types a case has seen so far, and
+    // whether a let or branch has a binding on the stack
+    struct State {
+        std::vector<Symbol> branchTypes;
+        bool bound = false;
+    };
+
+    ClassChecker(const TypeChecker& checker, ClassId id, std::ostream& errors)
+        : checker_(checker), id_(id), cls_(checker.Graph().GetClass(id)), errors_(errors) {}
+
+    void Check() {
+        for (Feature* feature : cls_.features) {
+            if (feature->isAttr) {
+                CheckAttribute(*feature);
+            } else {
+                CheckMethod(*feature);
+            }
+        }
+    }
+
+    void Enter(Expression& expr, State&) {
+        if (auto* assign = std::get_if<AssignExpr>(&expr.data_)) {
+            if (assign->id.value == names().self) {
+                Error(expr.lineOfCode) << "Cannot assign to 'self'.\n";
+            } else if (!Lookup(assign->id.value)) {
+                Error(expr.lineOfCode) << "Assignment to undeclared variable " << assign->id.value << ".\n";
+            }
+        } else if (auto* let = std::get_if<LetExpr>(&expr.data_)) {
+            if (!checker_.IsDefined(let->type.value)) {
+                Error(expr.lineOfCode) << "Class " << let->type.value << " of let-bound identifier " << let->id.value
+                                       << " is undefined.\n";
+            }
+        }
+    }
+
+    // the checks between subexpressions, and the bindings of lets and cases
+    State Child(Expression& expr, std::size_t idx, State& state) {
+        const std::size_t line = expr.lineOfCode;
+        if (auto* cond = std::get_if<CondExpr>(&expr.data_)) {
+            if (idx == 1 && cond->predicat->type != names().boolean) {
+                Error(line) << "Predicate of 'if' does not have type Bool.\n";
+            }
+        } else if (auto* loop = std::get_if<WhileExpr>(&expr.data_)) {
+            if (idx == 1 && loop->predicat->type != names().boolean) {
+                Error(line) << "Loop condition does not have type Bool.\n";
+            }
+        } else if (auto* let = std::get_if<LetExpr>(&expr.data_)) {
+            if (idx == 1) {
+                const Symbol& id = let->id.value;
+                const Symbol& type = let->type.value;
+                if (!checker_.Conforms(let->expr->type, type, id_)) {
+                    Error(line) << "Inferred type " << let->expr->type << " of initialization of " << id
+                                << " does not conform to identifier's declared type " << type << ".\n";
+                }
+                if (id == names().self) {
+                    Error(line) << "'self' cannot be bound in a 'let' expression.\n";
+                } else {
+                    scope_.Bind(id, type);
+                    state.bound = true;
+                }
+            }
+        } else if (auto* case_ = std::get_if<Case>(&expr.data_)) {
+            if (idx > 0) {
+                if (idx > 1) {
+                    scope_.Unbind();
+                }
+                BindBranch(*case_->branches[idx - 1], state);
+            }
+        }
+        return State();
+    }
+
+    void Leave(Expression& expr, State& state) {
+        expr.type = TypeOf(expr, state);
+    }
+
+   private:
+    void CheckAttribute(Feature& feature) {
+        const Symbol& type = feature.type.value;
+        if (!checker_.IsDefined(type)) {
+            Error(feature.lineOfCode) << "Class " << type << " of attribute " << feature.id.value << " is undefined.\n";
+        }
+        Walk(*feature.expr, State(), *this);
+        if (!checker_.Conforms(feature.expr->type, type, id_)) {
+            Error(feature.lineOfCode) << "Inferred type " << feature.expr->type << " of initialization of attribute "
+                                      << feature.id.value << " does not conform to declared type " << type << ".\n";
+        }
+    }
+
+    void CheckMethod(Feature& feature) {
+        for (const Formal& formal : feature.arguments) {
+            const Symbol& id = formal.id.value;
+            const Symbol& type = formal.type.value;
+            if (type == names().selfType) {
+                Error(formal.lineOfCode) << "Formal parameter " << id << " cannot have type SELF_TYPE.\n";
+            } else if (!checker_.IsDefined(type)) {
+                Error(formal.lineOfCode) << "Class " << type << " of formal parameter " << id << " is undefined.\n";
+            }
+            if (id == names().self) {
+                Error(formal.lineOfCode) << "'self' cannot be the name of a formal parameter.\n";
+            } else if (Lookup(id, /*localOnly=*/true)) {
+                Error(formal.lineOfCode) << "Formal parameter " << id << " is multiply defined.\n";
+            } else {
+                scope_.Bind(id, type);
+            }
+        }
+
+        const Symbol& type = feature.type.value;
+        const bool defined = checker_.IsDefined(type);
+        if (!defined) {
+            Error(feature.lineOfCode) << "Undefined return type " << type << " in method " << feature.id.value
+                                      << ".\n";
+        }
+        Walk(*feature.expr, State(), *this);
+        if (defined && !checker_.Conforms(feature.expr->type, type, id_)) {
+            Error(feature.lineOfCode) << "Inferred return type " << feature.expr->type << " of method "
+                                      << feature.id.value << " does not conform to declared return type " << type
+                                      << ".\n";
+        }
+        scope_.Clear();
+    }
+
+    void BindBranch(const BranchExpr& branch, State& state) {
+        const Symbol& id = branch.id.value;
+        const Symbol& type = branch.type.value;
+        const std::size_t line = branch.lineOfCode;
+        if (std::find(state.branchTypes.begin(), state.branchTypes.end(), type) != state.branchTypes.end()) {
+            Error(line) << "Duplicate branch " << type << " in case statement.\n";
+        } else {
+            state.branchTypes.push_back(type);
+        }
+        if (type != names().selfType && !checker_.IsDefined(type)) {
+            Error(line) << "Class " << type << " of case branch is undefined.\n";
+        }
+        if (id == names().self) {
+            Error(line) << "'self' bound in 'case'.\n";
+        }
+        if (type == names().selfType) {
+            Error(line) << "Identifier " << id << " declared with type SELF_TYPE in case branch.\n";
+        }
+        scope_.Bind(id, type);
+    }
+
+    Symbol TypeOf(Expression& expr, State& state) {
+        const Names& n = names();
+        const std::size_t line = expr.lineOfCode;
+        return std::visit(
+            overloaded{
+                [&](NegExpr& e) {
+                    if (e.rhs->type != n.integer) {
+                        Error(line) << "Argument of '~' has type " << e.rhs->type << " instead of Int.\n";
+                    }
+                    return n.integer;
+                },
+                [&](NotExpr& e) {
+                    if (e.rhs->type != n.boolean) {
+                        Error(line) << "Argument of 'not' has type " << e.rhs->type << " instead of Bool.\n";
+                    }
+                    return n.boolean;
+                },
+                [&](IsVoidExpr&) { return n.boolean; },
+                [&](PlusExpr& e) { return Arithmetic(e, "+", n.integer, line); },
+                [&](SubExpr& e) { return Arithmetic(e, "-", n.integer, line); },
+                [&](MulExpr& e) { return Arithmetic(e, "*", n.integer, line); },
+                [&](DivExpr& e) { return Arithmetic(e, "/", n.integer, line); },
+                [&](LessExpr& e) { return Arithmetic(e, "<", n.boolean, line); },
+                [&](LeExpr& e) { return Arithmetic(e, "<=", n.boolean, line); },
+                [&](EqExpr& e) {
+                    const Symbol& lhs = e.lhs->type;
+                    const Symbol& rhs = e.rhs->type;
+                    if (lhs != rhs && (IsBasic(lhs) || IsBasic(rhs))) {
+                        Error(line) << "Illegal comparison with a basic type.\n";
+                    }
+                    return n.boolean;
+                },
+                [&](AssignExpr& e) {
+                    const Symbol& type = e.expr->type;
+                    if (const Symbol* declared = Lookup(e.id.value);
+                        declared && !checker_.Conforms(type, *declared, id_)) {
+                        Error(line) << "Type " << type << " of assigned expression does not conform to declared type "
+                                    << *declared << " of identifier " << e.id.value << ".\n";
+                    }
+                    return type;
+                },
+                [&](IntExpr&) { return n.integer; },
+                [&](StringExpr&) { return n.string; },
+                [&](BoolExpr&) { return n.boolean; },
+                [&](IdentifierExpr& e) {
+                    if (const Symbol* type = Lookup(e.value)) {
+                        return *type;
+                    }
+                    Error(line) << "Undeclared identifier " << e.value << ".\n";
+                    return n.object;
+                },
+                [&](BlockExpr& e) { return e.exprs.back()->type; },
+                [&](CondExpr& e) { return checker_.Join(e.trueExpr->type, e.falseExpr->type, id_); },
+                [&](WhileExpr&) { return n.object; },
+                [&](Case& e) {
+                    scope_.Unbind();
+                    Symbol type = e.branches.front()->expr->type;
+                    for (std::size_t i = 1; i < e.branches.size(); ++i) {
+                        type = checker_.Join(type, e.branches[i]->expr->type, id_);
+                    }
+                    return type;
+                },
+                [&](LetExpr& e) {
+                    if (state.bound) {
+                        scope_.Unbind();
+                    }
+                    return e.inExpr->type;
+                },
+                [&](NewExpr& e) {
+                    if (checker_.IsDefined(e.type.value)) {
+                        return e.type.value;
+                    }
+                    Error(line) << "'new' used with undefined class " << e.type.value << ".\n";
+                    return n.object;
+                },
+                [&](NoExpr&) { return n.noType; },
+                [&](DispatchExpr& e) { return Dispatch(e, line); },
+            },
+            expr.data_);
+    }
+
+    Symbol Arithmetic(BinaryExpr& expr, const char* op, Symbol type, std::size_t line) {
+        if (expr.lhs->type != names().integer || expr.rhs->type != names().integer) {
+            Error(line) << "non-Int arguments: " << expr.lhs->type << " " << op << " " << expr.rhs->type << "\n";
+        }
+        return type;
+    }
+
+    Symbol Dispatch(DispatchExpr& expr, std::size_t line) {
+        const Names& n = names();
+        const Symbol& objType = expr.obj->type;
+        const bool isStatic = !expr.type.value.empty();
+        ClassId target;
+        if (isStatic) {
+            const Symbol& type = expr.type.value;
+            if (type == n.selfType) {
+                Error(line) << "Static dispatch to SELF_TYPE.\n";
+                return n.object;
+            }
+            target = checker_.Graph().Find(type);
+            if (target == ClassGraph::NO_CLASS) {
+                Error(line) << "Static dispatch to undefined class " << type << ".\n";
+                return n.object;
+            }
+            if (!checker_.Conforms(objType, type, id_)) {
+                Error(line) << "Expression type " << objType << " does not conform to declared static dispatch type "
+                            << type << ".\n";
+                return n.object;
+            }
+        } else {
+            target = objType == n.selfType ? id_ : checker_.Graph().Find(objType);
+            if (target == ClassGraph::NO_CLASS) {
+                Error(line) << "Dispatch on undefined class " << objType << ".\n";
+                return n.object;
+            }
+        }
+
+        const Feature* method = checker_.FindMethod(target, expr.id.value);
+        if (method == nullptr) {
+            Error(line) << (isStatic ? "Static dispatch" : "Dispatch") << " to undefined method " << expr.id.value
+                        << ".\n";
+            return n.object;
+        }
+        if (method->arguments.size() != expr.arguments.size()) {
+            Error(line) << "Method " << expr.id.value << (isStatic ? " invoked" : " called")
+                        << " with wrong number of arguments.\n";
+        } else {
+            for (std::size_t i = 0; i < expr.arguments.size(); ++i) {
+                const Formal& formal = method->arguments[i];
+                const Symbol& type = expr.arguments[i]->type;
+                if (!checker_.Conforms(type, formal.type.value, id_)) {
+                    Error(line) << "In call of method " << expr.id.value << ", type " << type << " of parameter "
+                                << formal.id.value << " does not conform to declared type " << formal.type.value
+                                << ".\n";
+                }
+            }
+        }
+        return method->type.value == n.selfType ? objType : method->type.value;
+    }
+
+    static bool IsBasic(const Symbol& type) {
+        return type == names().integer || type == names().string || type == names().boolean;
+    }
+
+    // the declared type of `id`, nullptr if it isn't declared
+    const Symbol* Lookup(const Symbol& id, bool localOnly = false) const {
+        if (const Symbol* type = scope_.Find(id); type || localOnly) {
+            return type;
+        }
+        if (id == names().self) {
+            return &names().selfType;
+        }
+        const Feature* attribute = checker_.FindAttribute(id_, id);
+        return attribute ? &attribute->type.value : nullptr;
+    }
+
+    std::ostream& Error(std::size_t line) {
+        return errors_ << cls_.filename << ":" << line << ": ";
+    }
+
+   private:
+    const TypeChecker& checker_;
+    const ClassId id_;
+    const Class& cls_;
+    std::ostream& errors_;
+    // formals of the method, then lets and case branches
+    Scope<> scope_;
+};
+
+}  // namespace
+
+TypeChecker::TypeChecker(const InheritanceAnalyzer& inheritance, std::size_t jobs)
+    : graph_(inheritance.Graph()),
+      hierarchy_(inheritance.Hierarchy()),
+      firstClass_(inheritance.FirstClass()),
+      jobs_(jobs),
+      tables_(graph_.Size()),
+      layout_(graph_.Size()) {
+    // before any thread asks for them
+    names();
+}
+
+bool TypeChecker::Check() {
+    const std::vector<ClassId>& order = hierarchy_.PreOrder();
+    // the tables of a class are its own business, the redefinitions only
+    // read the tables of its ancestors
+    ParallelFor(order.size(), jobs_, [&](std::size_t i) { BuildTables(order[i]); });
+    std::vector<std::ostringstream> tableErrors(order.size());
+    std::vector<std::vector<Symbol>> inherited(order.size());
+    ParallelFor(order.size(), jobs_,
+                [&](std::size_t i) { CheckTables(order[i], tableErrors[i], inherited[i]); });
+    bool status = true;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        // the name keeps meaning the inherited attribute
+        for (const Symbol& name : inherited[i]) {
+            tables_[order[i]].attributes.erase(name);
+        }
+        status = Flush(tableErrors[i]) && status;
+        LayOut(order[i]);
+    }
+    status = CheckMain() && status;
+
+    std::vector<ClassId> classes;
+    for (const ClassId id : order) {
+        if (id >= firstClass_) {
+            classes.push_back(id);
+        }
+    }
+    std::vector<std::ostringstream> errors(classes.size());
+    ParallelFor(classes.size(), jobs_, [&](std::size_t i) { ClassChecker(*this, classes[i], errors[i]).Check(); });
+    for (const auto& classErrors : errors) {
+        status = Flush(classErrors) && status;
+    }
+    return status;
+}
+
+void TypeChecker::BuildTables(ClassId id) {
+    ClassTables& tables = tables_[id];
+    for (const Feature* feature : graph_.GetClass(id).features) {
+        if (!feature->isAttr) {
+            tables.methods.emplace(feature->id.value, feature);
+        } else if (feature->id.value != names().self) {
+            tables.attributes.emplace(feature->id.value, feature);
+        }
+    }
+}
+
+void TypeChecker::CheckTables(ClassId id, std::ostream& errors, std::vector<Symbol>& inherited) const {
+    const Class& cls = graph_.GetClass(id);
+    const ClassId parent = graph_.Parent(id);
+    const ClassTables& tables = tables_[id];
+    auto error = [&](const Feature& feature) -> std::ostream& {
+        return errors << cls.filename << ":" << feature.lineOfCode << ": ";
+    };
+
+    for (const Feature* feature : cls.features) {
+        const Symbol& name = feature->id.value;
+        if (feature->isAttr) {
+            if (name == names().self) {
+                error(*feature) << "'self' cannot be the name of an attribute.\n";
+            } else if (FindInTables(parent, name, &ClassTables::attributes)) {
+                error(*feature) << "Attribute " << name << " is an attribute of an inherited class.\n";
+                inherited.push_back(name);
+            } else if (tables.attributes.at(name) != feature) {
+                error(*feature) << "Attribute " << name << " is multiply defined in class.\n";
+            }
+            continue;
+        }
+
+        if (tables.methods.at(name) != feature) {
+            error(*feature) << "Method " << name << " is multiply defined.\n";
+            continue;
+        }
+        const Feature* inherited = FindInTables(parent, name, &ClassTables::methods);
+        if (inherited == nullptr) {
+            continue;
+        }
+        // only the first difference is reported
+        if (feature->type.value != inherited->type.value) {
+            error(*feature) << "In redefined method " << name << ", return type " << feature->type.value
+                            << " is different from original return type " << inherited->type.value << ".\n";
+        } else if (feature->arguments.size() != inherited->arguments.size()) {
+            error(*feature) << "Incompatible number of formal parameters in redefined method " << name << ".\n";
+        } else {
+            for (std::size_t i = 0; i < feature->arguments.size(); ++i) {
+                const Symbol& type = feature->arguments[i].type.value;
+                const Symbol& original = inherited->arguments[i].type.value;
+                if (type != original) {
+                    // sic, no full stop
+                    error(*feature) << "In redefined method " << name << ", parameter type " << type
+                                    << " is different from original type " << original << "\n";
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool TypeChecker::Flush(const std::ostringstream& errors) {
+    const std::string text = errors.str();
+    std::cerr << text;
+    return text.empty();
+}
+
+bool TypeChecker::CheckMain() const {
+    const ClassId id = graph_.Find(names().main);
+    if (id == ClassGraph::NO_CLASS) {
+        std::cerr << "Class Main is not defined." << std::endl;
+        return false;
+    }
+    const Class& cls = graph_.GetClass(id);
+    const auto& methods = tables_[id].methods;
+    const auto it = methods.find(names().mainMethod);
+    if (it == methods.end()) {
+        std::cerr << cls.filename << ":" << cls.lineOfCode << ": No 'main' method in class Main." << std::endl;
+        return false;
+    }
+    if (!it->second->arguments.empty()) {
+        std::cerr << cls.filename << ":" << cls.lineOfCode << ": 'main' method in class Main should have no arguments."
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const Feature* TypeChecker::FindMethod(ClassId id, Symbol name) const {
+    const ClassLayout::Entry* entry = layout_.FindMethod(id, name);
+    return entry ? entry->feature : nullptr;
+}
+
+const Feature* TypeChecker::FindAttribute(ClassId id, Symbol name) const {
+    const ClassLayout::Entry* entry = layout_.FindAttribute(id, name);
+    return entry ? entry->feature : nullptr;
+}
+
+const Feature* TypeChecker::FindInTables(ClassId id, Symbol name, FeatureTable ClassTables::*table) const {
+    for (; id != ClassGraph::NO_CLASS; id = graph_.Parent(id)) {
+        const FeatureTable& features = tables_[id].*table;
+        if (const auto it = features.find(name); it != features.end()) {
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+void TypeChecker::LayOut(ClassId id) {
+    std::vector<const Feature*> methods;
+    std::vector<const Feature*> attributes;
+    // what the tables took, in definition order
+    for (const Feature* feature : graph_.GetClass(id).features) {
+        const FeatureTable& table = feature->isAttr ? tables_[id].attributes : tables_[id].methods;
+        const auto it = table.find(feature->id.value);
+        if (it != table.end() && it->second == feature) {
+            (feature->isAttr ? attributes : methods).push_back(feature);
+        }
+    }
+    layout_.Add(id, graph_.Parent(id), methods, attributes);
+}
+
+bool TypeChecker::IsDefined(Symbol type) const {
+    return type == names().selfType || graph_.Find(type) != ClassGraph::NO_CLASS;
+}
+
+bool TypeChecker::Conforms(Symbol lhs, Symbol rhs, ClassId self) const {
+    const Symbol& selfType = names().selfType;
+    if (lhs == selfType && rhs == selfType) {
+        return true;
+    }
+    const ClassId from = lhs == selfType ? self : graph_.Find(lhs);
+    if (rhs == selfType) {
+        return from == ClassGraph::NO_CLASS;
+    }
+    const ClassId to = graph_.Find(rhs);
+    if (from == ClassGraph::NO_CLASS || to == ClassGraph::NO_CLASS) {
+        return true;
+    }
+    return hierarchy_.Conforms(from, to);
+}
+
+Symbol TypeChecker::Join(Symbol lhs, Symbol rhs, ClassId self) const {
+    const Symbol& selfType = names().selfType;
+    if (lhs == selfType && rhs == selfType) {
+        return selfType;
+    }
+    const ClassId left = lhs == selfType ? self : graph_.Find(lhs);
+    const ClassId right = rhs == selfType ? self : graph_.Find(rhs);
+    if (left == ClassGraph::NO_CLASS) {
+        return rhs;
+    }
+    if (right == ClassGraph::NO_CLASS) {
+        return lhs;
+    }
+    return graph_.GetClass(hierarchy_.Join(left, right)).id.value;
+}
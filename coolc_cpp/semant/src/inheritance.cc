@@ -1 +0,0 @@
-#include "inheritance.h"
\ No newline at end of file
@@ -1,16 +1,51 @@
 #include <iostream>
+#include <string>
 
+#include "lexer/parallel.h"
 #include "parser/syntax.h"
-#include "inheritance.h"
+#include "semant/inheritance.h"
+#include "semant/type_checker.h"
 
+void usage() {
+    std::cerr << "Usage: ./semant [-p] [-j N]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // -p: print the program as it was read and stop, to check the reader
+    bool printOnly = false;
+    // -j: classes type checked at once
+    std::size_t jobs = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-p") {
+            printOnly = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            if (!ParseJobs(argv[++i], jobs)) {
+                usage();
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
 
-int main() {
     Program program = ReadProgram();
-    // PrintProgram(program);
+    if (printOnly) {
+        PrintProgram(program);
+        return 0;
+    }
     InheritanceAnalyzer inherAnalyzer(program);
     if (!inherAnalyzer.checkCorrectness()) {
         std::cerr << "Compilation halted due to static semantic errors." << std::endl;
         return 1;
     }
+    TypeChecker typeChecker(inherAnalyzer, jobs);
+    if (!typeChecker.Check()) {
+        std::cerr << "Compilation halted due to static semantic errors." << std::endl;
+        return 1;
+    }
+    // the typed AST, as the reference semant prints it
+    PrintProgram(program);
     return 0;
-}
\ No newline at end of file
+}
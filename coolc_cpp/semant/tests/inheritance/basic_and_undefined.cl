@@ -0,0 +1,9 @@
+class Main { main() : Int { 0 }; };
+class A inherits B { };
+class B inherits C { };
+class C inherits A { };
+class D inherits C { };
+class E inherits E { };
+class F inherits Z { };
+class G inherits Int { };
+class H inherits G { };
@@ -0,0 +1,6 @@
+class Main {main():Int{0};};
+class Object { };
+class IO {};
+class String{};
+class B inherits IO {};
+class C inherits Object{};
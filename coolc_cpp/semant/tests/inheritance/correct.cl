@@ -0,0 +1 @@
+class Main {main():Int{0};};
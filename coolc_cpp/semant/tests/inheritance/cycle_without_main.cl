@@ -0,0 +1,2 @@
+class A inherits B { };
+class B inherits A { };
@@ -0,0 +1,8 @@
+class Main { main() : Int { 0 }; };
+class A inherits B { };
+class B inherits C { };
+class C inherits A { };
+class D inherits C { };
+class E inherits E { };
+class X inherits D { };
+class Y inherits Main { };
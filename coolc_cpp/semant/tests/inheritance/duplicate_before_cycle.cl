@@ -0,0 +1,4 @@
+class Main {main():Int{0};};
+class A inherits B { };
+class B inherits A { };
+class Main {};
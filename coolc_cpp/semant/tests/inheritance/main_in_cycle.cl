@@ -0,0 +1,5 @@
+class Main inherits A {main():Int{0};};
+class A inherits B { };
+class B inherits A { };
+class K inherits Main {};
+class L inherits K{};
@@ -0,0 +1,9 @@
+class Main { main() : Int { 0 }; };
+class A inherits Z { };
+class B inherits Int { };
+class C inherits Y { };
+class A { };
+class Int { };
+class D inherits SELF_TYPE { };
+class SELF_TYPE { };
+class E inherits Bool { };
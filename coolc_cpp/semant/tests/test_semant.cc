@@ -1,13 +1,24 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdio>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <random>
 #include <stdexcept>
 #include <string>
 
+#include "semant/class_graph.h"
+#include "semant/class_hierarchy.h"
+#include "semant/class_layout.h"
+#include "semant/inheritance.h"
+#include "semant/scope.h"
+#include "semant/type_checker.h"
+
 std::string exec(const char* cmd) {
     std::array<char, 128> buffer;
     std::string result;
@@ -57,11 +68,142 @@ void compare_semants(const std::vector<std::string>& files) {
     }
 }
 
+// the reader gives back exactly the AST the reference parser printed
+void compare_read_ast(const std::vector<std::string>& files) {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(),
+              std::ostream_iterator<std::string>(imploded, " "));
+
+    const std::string input = "../../resource/bin/lexer " + imploded.str() + " | ../../resource/bin/parser";
+    std::string reference_output = exec(input.c_str());
+    std::string output = exec((input + " | ./semant -p").c_str());
+    ASSERT_EQ(reference_output, output);
+}
+
+TEST(Reader, RoundTrip) {
+    for (const auto& path : {"../../../examples", "../../semant/tests/end-to-end"}) {
+        for (const auto& entry : std::filesystem::directory_iterator(path)) {
+            if (entry.path().extension() == ".cl" || entry.path().extension() == ".test") {
+                compare_read_ast({entry.path()});
+            }
+        }
+    }
+}
+
+TEST(Reader, MultipleFiles) {
+    compare_read_ast({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"});
+}
+
+// the binary AST of `parser -b` reads back to the same program; from a
+// file as well, which is mapped rather than read
+void compare_read_binary_ast(const std::vector<std::string>& files) {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(),
+              std::ostream_iterator<std::string>(imploded, " "));
+
+    const std::string lexer = "../../resource/bin/lexer " + imploded.str();
+    const std::string path = std::filesystem::temp_directory_path() / "read_binary_ast.bin";
+    std::string reference_output = exec((lexer + " | ../../resource/bin/parser").c_str());
+    ASSERT_EQ(reference_output, exec((lexer + " | ./parser -b | ./semant -p").c_str()));
+    exec((lexer + " | ./parser -b > " + path).c_str());
+    ASSERT_EQ(reference_output, exec(("./semant -p < " + path).c_str()));
+    std::filesystem::remove(path);
+}
+
+TEST(Reader, BinaryAst) {
+    for (const auto& entry : std::filesystem::directory_iterator("../../../examples")) {
+        if (entry.path().extension() == ".cl") {
+            compare_read_binary_ast({entry.path()});
+        }
+    }
+    compare_read_binary_ast({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"});
+}
+
+// a dump no parser prints is refused, not handed to the checker
+void expect_malformed(const std::string& body) {
+    const std::string path = std::filesystem::temp_directory_path() / "malformed.ast";
+    std::ofstream(path) << "#1\n_program\n  #1\n  _class\n    Main\n    Object\n    \"m.cl\"\n    (\n"
+                           "    #1\n    _method\n      main\n      Object\n"
+                        << body << "    )\n";
+    const std::string output = exec(("./semant -p < " + path + " 2>&1").c_str());
+    EXPECT_NE(output.find("malformed AST"), std::string::npos) << body;
+    std::filesystem::remove(path);
+}
+
+TEST(Reader, Malformed) {
+    // a block without expressions
+    expect_malformed("      #1\n      _block\n      : _no_type\n");
+    // a case without branches
+    expect_malformed("      #1\n      _typcase\n        #1\n        _int\n          1\n        : _no_type\n"
+                     "      : _no_type\n");
+}
+
 TEST(Dummy, test) {
     const std::string path = "../../../examples/hello_world.cl";
     compare_semants({path});
 }
 
+// class hierarchy errors match the reference line for line, order included
+void compare_inheritance_errors(const std::vector<std::string>& files) {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(),
+              std::ostream_iterator<std::string>(imploded, " "));
+
+    const std::string input = "../../resource/bin/lexer " + imploded.str() + " | ../../resource/bin/parser";
+    std::string reference_output = exec((input + " | ../../resource/bin/semant 2>&1 1>/dev/null").c_str());
+    std::string output = exec((input + " | ./semant 2>&1 1>/dev/null").c_str());
+    ASSERT_EQ(reference_output, output);
+}
+
+TEST(Inheritance, Errors) {
+    for (const auto& entry : std::filesystem::directory_iterator("../../semant/tests/inheritance")) {
+        compare_inheritance_errors({entry.path()});
+    }
+}
+
+TEST(Inheritance, MultipleFiles) {
+    compare_inheritance_errors({"../../semant/tests/inheritance/cycles.cl",
+                                "../../semant/tests/inheritance/main_in_cycle.cl"});
+    compare_inheritance_errors({"../../semant/tests/inheritance/no_main.cl",
+                                "../../semant/tests/inheritance/cycle_without_main.cl"});
+}
+
+// the typed AST on correct programs, all errors in order otherwise
+void compare_type_check(const std::vector<std::string>& files, const std::string& flags = "") {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(),
+              std::ostream_iterator<std::string>(imploded, " "));
+
+    const std::string input = "../../resource/bin/lexer " + imploded.str() + " | ../../resource/bin/parser";
+    std::string reference_output = exec((input + " | ../../resource/bin/semant 2>&1").c_str());
+    std::string output = exec((input + " | ./semant " + flags + " 2>&1").c_str());
+    ASSERT_EQ(reference_output, output) << imploded.str();
+}
+
+TEST(TypeChecker, Errors) {
+    for (const auto& entry : std::filesystem::directory_iterator("../../semant/tests/typecheck")) {
+        compare_type_check({entry.path()});
+    }
+}
+
+TEST(TypeChecker, EndToEnd) {
+    for (const auto& path : {"../../../examples", "../../semant/tests/end-to-end"}) {
+        for (const auto& entry : std::filesystem::directory_iterator(path)) {
+            if (entry.path().extension() == ".cl" || entry.path().extension() == ".test") {
+                compare_type_check({entry.path()});
+            }
+        }
+    }
+    compare_type_check({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"});
+}
+
+TEST(TypeChecker, Parallel) {
+    compare_type_check({"../../semant/tests/typecheck/expressions.cl",
+                        "../../semant/tests/typecheck/features.cl"}, "-j 4");
+    compare_type_check({"../../../examples/life.cl"}, "-j 4");
+    compare_type_check({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"}, "-j 2");
+}
+
 // TEST(EndToEnd, Multiple) {
 //     const std::string example_stack = "../../stack_example/stack.cl";
 //     compare_parsers({example_stack});
@@ -74,3 +216,216 @@ TEST(Dummy, test) {
 //         compare_parsers({entry.path()});
 //     }
 // }
+
+// Class i inherits from parents[i], class 0 is the root. Subtyping and
+// joins of the index are checked against walking up the parents.
+void compare_hierarchy(const std::vector<uint32_t>& parents, std::size_t queries) {
+    Arena arena;
+    ClassGraph graph;
+    for (std::size_t i = 0; i < parents.size(); ++i) {
+        const Symbol base = i == 0 ? Symbol("_no_class") : Symbol("C" + std::to_string(parents[i]));
+        const Symbol id("C" + std::to_string(i));
+        graph.Add(arena.make<Class>(Class{.id = {id}, .baseClass = {base}, .features = {}, .filename = {},
+                                          .lineOfCode = INVALID_LINE_OF_CODE}));
+    }
+    graph.Link(0);
+    const ClassHierarchy hierarchy(graph, 0);
+
+    auto ancestors = [&](uint32_t id) {
+        std::vector<uint32_t> chain = {id};
+        while (id != 0) {
+            chain.push_back(id = parents[id]);
+        }
+        return chain;
+    };
+    std::mt19937 random(parents.size());
+    std::uniform_int_distribution<uint32_t> pick(0, parents.size() - 1);
+    for (std::size_t i = 0; i < queries; ++i) {
+        const uint32_t lhs = pick(random);
+        // close relatives now and then, or deep chains would never conform
+        const auto lhsChain = ancestors(lhs);
+        const uint32_t rhs = i % 2 ? pick(random) : lhsChain[pick(random) % lhsChain.size()];
+        std::vector<char> aboveRhs(parents.size());
+        for (uint32_t id : ancestors(rhs)) {
+            aboveRhs[id] = 1;
+        }
+
+        const bool conforms = std::find(lhsChain.begin(), lhsChain.end(), rhs) != lhsChain.end();
+        ASSERT_EQ(conforms, hierarchy.Conforms(lhs, rhs)) << lhs << " <= " << rhs;
+        const uint32_t join = *std::find_if(lhsChain.begin(), lhsChain.end(), [&](uint32_t id) { return aboveRhs[id]; });
+        ASSERT_EQ(join, hierarchy.Join(lhs, rhs)) << lhs << " join " << rhs;
+    }
+}
+
+TEST(Hierarchy, Deep) {
+    std::vector<uint32_t> parents(5000);
+    for (uint32_t i = 1; i < parents.size(); ++i) {
+        // a long spine with short branches off it
+        parents[i] = i % 3 ? i - 1 : i - 2;
+    }
+    compare_hierarchy(parents, 2000);
+}
+
+TEST(Hierarchy, Wide) {
+    std::vector<uint32_t> parents(100000);
+    std::mt19937 random(7);
+    for (uint32_t i = 1; i < parents.size(); ++i) {
+        parents[i] = random() % std::min<uint32_t>(i, 16);
+    }
+    compare_hierarchy(parents, 20000);
+}
+
+TEST(Hierarchy, Random) {
+    std::vector<uint32_t> parents(20000);
+    std::mt19937 random(11);
+    for (uint32_t i = 1; i < parents.size(); ++i) {
+        parents[i] = random() % i;
+    }
+    compare_hierarchy(parents, 20000);
+}
+
+TEST(Scope, Shadowing) {
+    Scope<> scope;
+    scope.Bind("x", "Int");
+    scope.Bind("y", "Bool");
+    scope.Bind("x", "String");
+    ASSERT_EQ(*scope.Find("x"), "String");
+    scope.Unbind();
+    ASSERT_EQ(*scope.Find("x"), "Int");
+    ASSERT_EQ(*scope.Find("y"), "Bool");
+    scope.Unbind();
+    scope.Unbind();
+    ASSERT_EQ(scope.Find("x"), nullptr);
+    ASSERT_EQ(scope.Depth(), 0);
+}
+
+// main() : Int { let x0 : Int <- 0 in let x1 : Int <- x0 in ... in x0 },
+// each initialization naming the outermost binding: a scope searched from
+// the top takes time quadratic in the depth here
+TEST(Scope, DeepLet) {
+    const std::size_t depth = 100000;
+    Program program;
+    Arena& arena = program.arena;
+    const Symbol integer = "Int";
+    const Symbol outermost = "x0";
+    auto identifier = [&] { return arena.make<Expression>(Expression{IdentifierExpr{outermost}, 1}); };
+
+    Expression* body = identifier();
+    for (std::size_t i = depth; i-- > 0;) {
+        Expression* init = i == 0 ? arena.make<Expression>(Expression{IntExpr{0}, 1}) : identifier();
+        body = arena.make<Expression>(
+            Expression{LetExpr{IdentifierExpr{"x" + std::to_string(i)}, Type{integer}, init, body}, 1});
+    }
+    Feature* main = arena.make<Feature>(Feature{IdentifierExpr{"main"}, {}, Type{integer}, body, 1, false});
+    program.classes.push_back(arena.make<Class>(Class{Type{"Main"}, Type{"Object"}, {main}, "deep_let.cl", 1}));
+
+    InheritanceAnalyzer inheritance(program);
+    ASSERT_TRUE(inheritance.checkCorrectness());
+    TypeChecker checker(inheritance);
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(checker.Check());
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << depth << " nested lets checked in " << elapsed.count() << " ms" << std::endl;
+    ASSERT_EQ(body->type, integer);
+}
+
+// the dispatch tables of the layout are those the reference cgen emits,
+// slot for slot
+void compare_dispatch_tables(const std::vector<std::string>& files) {
+    std::ostringstream imploded;
+    std::copy(files.begin(), files.end(),
+              std::ostream_iterator<std::string>(imploded, " "));
+
+    const std::string input = "../../resource/bin/lexer " + imploded.str() + " | ../../resource/bin/parser";
+    Program program;
+    ASSERT_TRUE(ReadProgram(exec(input.c_str()), program));
+    InheritanceAnalyzer inheritance(program);
+    ASSERT_TRUE(inheritance.checkCorrectness());
+    TypeChecker checker(inheritance);
+    if (!checker.Check()) {
+        // not a whole program, see TypeChecker.EndToEnd
+        return;
+    }
+
+    std::istringstream reference(
+        exec((input + " | ../../resource/bin/semant | ../../resource/bin/cgen").c_str()));
+    std::string line;
+    std::size_t tables = 0;
+    while (getline(reference, line)) {
+        const std::string suffix = "_dispTab:";
+        if (!line.ends_with(suffix)) {
+            continue;
+        }
+        const std::string name = line.substr(0, line.size() - suffix.size());
+        const ClassGraph::ClassId id = checker.Graph().Find(name);
+        ASSERT_NE(id, ClassGraph::NO_CLASS) << name;
+        for (const ClassLayout::Entry& entry : checker.Layout().Methods(id)) {
+            const Class& owner = checker.Graph().GetClass(entry.owner);
+            ASSERT_TRUE(getline(reference, line));
+            ASSERT_EQ(line, "\t.word\t" + owner.id.value.str() + "." + entry.feature->id.value.str()) << name;
+            ASSERT_EQ(checker.Layout().MethodSlot(id, entry.feature->id.value),
+                      &entry - checker.Layout().Methods(id).data());
+        }
+        ++tables;
+    }
+    ASSERT_EQ(tables, checker.Graph().Size());
+}
+
+TEST(Layout, DispatchTables) {
+    for (const auto& entry : std::filesystem::directory_iterator("../../../examples")) {
+        if (entry.path().extension() == ".cl") {
+            compare_dispatch_tables({entry.path()});
+        }
+    }
+    compare_dispatch_tables({"../../stack_example/stack.cl", "../../stack_example/atoi.cl"});
+}
+
+// A chain of classes, each with an attribute and a method of its own, lays
+// out in one shared table; a class redefining a method gets a copy.
+TEST(Layout, SharedPrefix) {
+    const std::size_t depth = 1000;
+    const std::size_t redefining = 500;
+    Program program;
+    Arena& arena = program.arena;
+    const Symbol integer = "Int";
+    auto zero = [&] { return arena.make<Expression>(Expression{IntExpr{0}, 1}); };
+    for (std::size_t i = 0; i < depth; ++i) {
+        const std::string name = "C" + std::to_string(i);
+        const Symbol base = i == 0 ? Symbol("Object") : Symbol("C" + std::to_string(i - 1));
+        Feature* attribute = arena.make<Feature>(Feature{IdentifierExpr{"a" + name}, {}, Type{integer}, zero(), 1, true});
+        Feature* method = arena.make<Feature>(Feature{IdentifierExpr{"m" + name}, {}, Type{integer}, zero(), 1, false});
+        Class cls{Type{name}, Type{base}, {attribute, method}, "chain.cl", 1};
+        if (i == redefining) {
+            cls.features.push_back(arena.make<Feature>(Feature{IdentifierExpr{"mC0"}, {}, Type{integer}, zero(), 1, false}));
+        }
+        program.classes.push_back(arena.make<Class>(cls));
+    }
+    Feature* main = arena.make<Feature>(Feature{IdentifierExpr{"main"}, {}, Type{integer}, zero(), 1, false});
+    program.classes.push_back(arena.make<Class>(Class{Type{"Main"}, Type{"Object"}, {main}, "chain.cl", 1}));
+
+    InheritanceAnalyzer inheritance(program);
+    ASSERT_TRUE(inheritance.checkCorrectness());
+    TypeChecker checker(inheritance);
+    ASSERT_TRUE(checker.Check());
+    const ClassLayout& layout = checker.Layout();
+    const ClassGraph& graph = checker.Graph();
+
+    const ClassGraph::ClassId last = graph.Find("C" + std::to_string(depth - 1));
+    const ClassGraph::ClassId object = inheritance.ObjectClass();
+    ASSERT_EQ(layout.Attributes(last).size(), depth);
+    ASSERT_EQ(layout.Methods(last).size(), depth + 3);
+    for (std::size_t i = 0; i < depth; ++i) {
+        const ClassGraph::ClassId id = graph.Find("C" + std::to_string(i));
+        ASSERT_EQ(layout.AttributeOffset(last, "aC" + std::to_string(i)), i);
+        ASSERT_EQ(layout.MethodSlot(last, "mC" + std::to_string(i)), i + 3);
+        ASSERT_EQ(layout.AttributeOffset(id, "aC" + std::to_string(i + 1)), ClassLayout::NO_SLOT);
+        // the redefinition keeps the slot and is what classes below it call
+        ASSERT_EQ(layout.FindMethod(id, "mC0")->owner, i < redefining ? graph.Find("C0") : graph.Find("C500"));
+        ASSERT_EQ(layout.MethodSlot(id, "mC0"), 3);
+        ASSERT_EQ(layout.FindMethod(id, "copy")->owner, object);
+    }
+    // one attribute table for the chain; the method table is copied once,
+    // at the redefinition, next to those of the basic classes
+    ASSERT_LE(layout.AttributeStorage(), depth + 8);
+    ASSERT_LE(layout.MethodStorage(), depth + redefining + 3 + 40);
+}
@@ -0,0 +1,7 @@
+class C1 inherits C3 { f() : Int { true }; };
+class C2 { f() : Int { true }; };
+class C3 { f() : Int { true }; };
+class C4 inherits C3 { f() : Int { true }; };
+class Main inherits C2 { main() : Int { true }; };
+class C6 inherits IO { f() : Int { true }; };
+class C7 inherits C1 { f() : Int { true }; };
@@ -0,0 +1,54 @@
+class Main inherits IO {
+  a : Int;
+  b : Bool;
+  s : String;
+  main() : Object {
+    {
+      self <- 1;
+      undeclared <- 2;
+      a <- "one";
+      a <- nowhere;
+      new Z;
+      if 1 then a else s fi;
+      while "s" loop a pool;
+      not 3;
+      ~ true;
+      a + b;
+      s - a;
+      b * s;
+      a / a;
+      s < a;
+      b <= a;
+      a = s;
+      b = b;
+      self = new Main;
+      isvoid a;
+      let x : Z <- 1 in x;
+      let y : Int <- true in y;
+      let self : Int <- 1 in self;
+      let z : SELF_TYPE <- self in z;
+      case a of
+        i : Int => i;
+        j : Int => j;
+        k : Q => k;
+        self : Bool => self;
+        m : SELF_TYPE => m;
+      esac;
+      a@SELF_TYPE.copy();
+      a@Z.copy();
+      a@String.length();
+      a@Int.nothing();
+      a@Int.copy(1);
+      q.f();
+      a.nothing();
+      a.copy(1, 2);
+      out_string(1);
+      out_int(true).out_string(a);
+      f(1, "s", b, new Main);
+    }
+  };
+  f(x : Int, y : Object, z : Main, w : SELF_TYPE) : SELF_TYPE { self };
+  g() : SELF_TYPE { new Main };
+  h() : Main { if b then self else new Object fi };
+  k() : Bool { case a of x : Main => x; y : IO => y; esac };
+};
@@ -0,0 +1,3 @@
+class Main { x : Int; x : Bool; f(a : Int, a : Bool) : Int { 0 }; f() : Int { 1 }; g() : Int { true }; self : Int; };
+class A { h(self : Int) : Int { 0 }; k(b : SELF_TYPE) : Int {0}; m(c : Z) : Y {0}; q : Q; };
+class B inherits Main { x : Int; f(a : Int, a : Bool) : Bool { 0 }; g(a:Int) : Int { 0 }; };
@@ -0,0 +1,2 @@
+class Main { main(x : Int) : Int { 0 }; };
+class A inherits Main { main() : Int { 0 }; };
@@ -0,0 +1,2 @@
+class A { main() : Int { 0 }; };
+class Main inherits A { };
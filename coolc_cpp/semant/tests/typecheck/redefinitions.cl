@@ -0,0 +1,39 @@
+class Main inherits C {
+  f(a : Int, b : Bool, c : String) : Int { 0 };
+  x : Int;
+};
+class B inherits Main {
+  f(a : Bool,
+    b : Int,
+    c : String) : Int { 0 };
+  x : Int;
+  x : Bool;
+  g(a : SELF_TYPE,
+    a : Z,
+    self : Int) : Int
+  {
+    {
+      1;
+      true;
+    }
+  };
+  h() : Int {
+    (new Main)
+      .f(
+        true,
+        3,
+        "s"
+      )
+  };
+  k() : Int {
+    let a : Z <- 1,
+      b : Int <- true
+    in
+      b
+  };
+};
+class C {
+  main(
+    x : Int
+  ) : Int { 0 };
+};